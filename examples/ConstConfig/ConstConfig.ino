@@ -0,0 +1,56 @@
+/***************************************************
+ * CParser - compile time configuration parsing
+ *
+ * With C++14 or later (ESP32, ESP8266, most ARM cores) the configuration
+ * string is parsed by the compiler: a malformed string breaks the build and
+ * no parsing code runs at boot. Older toolchains parse it at run time.
+ ****************************************************/
+
+#include <CParserView.h>
+
+struct SerialConfig {
+	uint32_t baud;
+	uint8_t bits;
+	char parity;
+	uint8_t stop;
+	bool valid;
+};
+
+CPARSER_CONSTEXPR SerialConfig parseConfig(const char *text) {
+	CParserView view(text);
+	SerialConfig config = { 0, 0, 'N', 1, false };
+
+	view.expect("baud=");
+	config.baud = view.readUnsignedInt32();
+	view.expect(';');
+	view.expect("mode=");
+	config.bits = view.readUnsignedInt8();
+	config.parity = view.readChar();
+	config.stop = view.readUnsignedInt8();
+	config.valid = !view.isError() && view.isBufferOverflow();
+
+	return config;
+}
+
+#if __cplusplus >= 201402L
+constexpr SerialConfig config = parseConfig("baud=115200;mode=8N1");
+static_assert(config.valid, "malformed serial configuration");
+#else
+const SerialConfig config = parseConfig("baud=115200;mode=8N1");
+#endif
+
+void setup()
+{
+	Serial.begin(config.baud);
+	while (!Serial) { ; }
+	Serial.print("Data bits:");
+	Serial.println(config.bits);
+	Serial.print("Parity:");
+	Serial.println(config.parity);
+	Serial.print("Stop bits:");
+	Serial.println(config.stop);
+}
+
+void loop()
+{
+}
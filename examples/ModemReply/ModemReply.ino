@@ -0,0 +1,57 @@
+/***************************************************
+ * CParser - modem replies with compiled patterns
+ *
+ * The patterns are compiled once (by the compiler with C++14 or later) and
+ * scanned in a single pass without backtracking. Capture groups give the
+ * position of the fields, read back with a parser on the same buffer.
+ ****************************************************/
+
+#include <CParser.h>
+#include <CParserPattern.h>
+
+#if __cplusplus >= 201402L
+constexpr CParserPattern signalPattern("\\+CSQ: (\\d+),(\\d+)");
+constexpr CParserPattern clockPattern("(\\d{2}):(\\d{2}):(\\d{2})");
+#else
+const CParserPattern signalPattern("\\+CSQ: (\\d+),(\\d+)");
+const CParserPattern clockPattern("(\\d{2}):(\\d{2}):(\\d{2})");
+#endif
+
+char reply[] = "AT+CSQ\r\n+CSQ: 17,99\r\n+CCLK: \"26/10/19,08:45:12+08\"\r\nOK\r\n";
+
+CParser parser(reply);
+CParserMatch match;
+
+uint8_t readGroup(uint8_t group) {
+	CParser field;
+	field.begin(parser, match.groups[group].start, match.groups[group].length);
+	return field.readUnsignedInt8();
+}
+
+void setup()
+{
+	Serial.begin(115200);
+	while (!Serial) { ; }
+
+	if (parser.search(signalPattern, match)) {
+		Serial.print("RSSI:");
+		Serial.println(readGroup(0));
+		Serial.print("BER:");
+		Serial.println(readGroup(1));
+	}
+
+	parser.reset();
+	if (parser.search(clockPattern, match)) {
+		Serial.print("Time:");
+		Serial.print(readGroup(0));
+		Serial.print('h');
+		Serial.print(readGroup(1));
+		Serial.print('m');
+		Serial.print(readGroup(2));
+		Serial.println('s');
+	}
+}
+
+void loop()
+{
+}
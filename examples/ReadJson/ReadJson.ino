@@ -0,0 +1,60 @@
+/***************************************************
+ * CParser - on-demand JSON reading
+ *
+ * The document is navigated in place: keys are looked up, values read with
+ * the number readers and arrays walked element by element. Numbers may carry
+ * an exponent. A value read only in part (a float read as an integer) is
+ * skipped whole on the next move.
+ ****************************************************/
+
+#include <CParser.h>
+#include <CParserJson.h>
+
+char reply[] = "{\"sensor\":\"t1\",\"temp\":21.5,\"peak\":2.5e1,\"samples\":[1.5, 2, 3],\"ok\":true}";
+
+CParser parser(reply);
+CParserJson json(parser);
+
+void setup()
+{
+	Serial.begin(115200);
+	while (!Serial) { ; }
+
+	if (!json.enterObject()) {
+		return;
+	}
+
+	if (json.findKey("temp")) {
+		Serial.print("Temp:");
+		Serial.println(json.readInt32());
+	}
+
+	if (json.findKey("peak")) {
+		Serial.print("Peak:");
+		Serial.println(json.readFloat());
+	}
+
+	if (json.findKey("samples") && json.enterArray()) {
+		while (json.nextElement()) {
+			Serial.print("Sample:");
+			Serial.println(json.readInt32());
+		}
+		json.leave();
+	}
+
+	if (json.findKey("sensor")) {
+		char name[8];
+		json.readString(name, sizeof(name));
+		Serial.print("Sensor:");
+		Serial.println(name);
+	}
+
+	if (json.findKey("ok")) {
+		Serial.print("Ok:");
+		Serial.println(json.readBool());
+	}
+}
+
+void loop()
+{
+}
@@ -0,0 +1,43 @@
+/***************************************************
+ * CParser - parse, transform and emit without heap
+ *
+ * A sensor frame is read with CParser and re-emitted in another format with
+ * CWriter, straight into a fixed buffer: no String, no dynamic allocation.
+ ****************************************************/
+
+#include <CParser.h>
+#include <CWriter.h>
+
+char frame[] = "T=23.46;H=41;P=101325";
+char output[48];
+
+CParser parser(frame);
+CWriter writer(output, sizeof(output));
+
+void setup()
+{
+	Serial.begin(115200);
+	while (!Serial) { ; }
+
+	parser.jumpAfter('=');
+	int32_t temperature = parser.readDecimal(1);
+	parser.jumpAfter('=');
+	uint8_t humidity = parser.readUnsignedInt8();
+	parser.jumpAfter('=');
+	float pressure = parser.readUnsignedInt32() / 100.0f;
+
+	writer.writeCharArray("$ENV");
+	writer.setSeparator(',');
+	writer.writeDecimal(temperature, 1);
+	writer.writeUnsignedInt8(humidity);
+	writer.writeFloat(pressure, 2);
+	writer.writeFloat(pressure * 0.0295300f);
+
+	if (!writer.isOverflow()) {
+		Serial.println(output);
+	}
+}
+
+void loop()
+{
+}
@@ -27,21 +27,77 @@
  ************************************************************************************/
 
 #include "CParser.h"
+#include "CParserByteSet.h"
+#include "CParserUtf8.h"
+#include "CParserTokenCache.h"
+#include "CParserPattern.h"
+
+CParserBudget::CParserBudget(size_t steps) {
+	m_steps = steps;
+	m_start = 0;
+	m_duration = 0;
+	m_timed = false;
+}
+
+// Budget that expires duration microseconds from now
+CParserBudget CParserBudget::within(uint32_t duration) {
+	CParserBudget budget(0);
+	budget.m_start = micros();
+	budget.m_duration = duration;
+	budget.m_timed = true;
+	return budget;
+}
+
+size_t CParserBudget::available(size_t wanted) {
+	if (m_timed) {
+		if ((uint32_t)(micros() - m_start) >= m_duration) {
+			return 0;
+		}
+		return wanted < CPARSER_BUDGET_CHUNK ? wanted : CPARSER_BUDGET_CHUNK;
+	}
+	return wanted < m_steps ? wanted : m_steps;
+}
+
+void CParserBudget::spend(size_t steps) {
+	if (!m_timed) {
+		m_steps -= steps < m_steps ? steps : m_steps;
+	}
+}
 
-CParser::CParser() { }
+bool CParserBudget::isExhausted() {
+	return available(1) == 0;
+}
+
+CParser::CParser() {
+	m_buf = nullptr;
+	m_wrap = nullptr;
+	m_split = 0;
+	m_len = 0;
+	m_pos = 0;
+	m_reading = false;
+	m_cache = nullptr;
+}
 
 CParser::CParser(String &str) {
+	m_cache = nullptr;
 	begin(str);
 }
 
 CParser::CParser(char *str) {
+	m_cache = nullptr;
 	begin(str);
 }
 
 CParser::CParser(byte *buf, size_t len) {
+	m_cache = nullptr;
 	begin(buf, len);
 }
 
+CParser::CParser(byte *base, size_t capacity, size_t head, size_t tail) {
+	m_cache = nullptr;
+	begin(base, capacity, head, tail);
+}
+
 CParser::~CParser() { }
 
 void CParser::begin(String &str) {
@@ -54,27 +110,107 @@ void CParser::begin(char *str) {
 
 void CParser::begin(byte *buf, size_t len) {
 	m_buf = buf;
+	m_wrap = buf + len;
+	m_split = len;
 	m_len = len;
 	m_pos = 0;
+	m_reading = false;
+	if (m_cache != nullptr) {
+		m_cache->invalidate(m_len);
+	}
+}
+
+// Ring buffer input: head is the index of the first unread byte, tail the index
+// one past the last one. Data wrapping past the end of the ring is read in place
+// as two spans; char array callbacks get a token straddling the wrap in two calls.
+void CParser::begin(byte *base, size_t capacity, size_t head, size_t tail) {
+	size_t len = (tail >= head) ? tail - head : capacity - head + tail;
+
+	m_buf = base + head;
+	m_len = len;
+	m_pos = 0;
+	m_reading = false;
+	if (len > capacity - head) {
+		m_split = capacity - head;
+		m_wrap = base;
+	} else {
+		m_split = len;
+		m_wrap = m_buf + len;
+	}
+	if (m_cache != nullptr) {
+		m_cache->invalidate(m_len);
+	}
+}
+
+// Begins on length items of another parser starting at its position from,
+// sharing the buffer (and ring layout) without copying.
+void CParser::begin(const CParser &source, size_t from, size_t length) {
+	if (from > source.m_len) {
+		from = source.m_len;
+	}
+	if (length > source.m_len - from) {
+		length = source.m_len - from;
+	}
+
+	m_len = length;
+	m_pos = 0;
+	m_reading = false;
+	if (from >= source.m_split) {
+		m_buf = source.m_wrap + (from - source.m_split);
+		m_split = length;
+		m_wrap = m_buf + length;
+	} else if (from + length > source.m_split) {
+		m_buf = source.m_buf + from;
+		m_split = source.m_split - from;
+		m_wrap = source.m_wrap;
+	} else {
+		m_buf = source.m_buf + from;
+		m_split = length;
+		m_wrap = m_buf + length;
+	}
+	if (m_cache != nullptr) {
+		m_cache->invalidate(m_len);
+	}
+}
+
+// Caches the boundaries of separator (or of the items matching criterion):
+// passes after reset() reuse those recorded by the previous ones until the
+// next begin(). Scans for anything else go through the buffer as usual.
+void CParser::attachCache(CParserTokenCache *cache, char separator) {
+	m_cache = cache;
+	if (m_cache != nullptr) {
+		m_cache->bind((byte)separator);
+		m_cache->invalidate(m_len);
+	}
+}
+
+void CParser::attachCache(CParserTokenCache *cache, CParserCriterion criterion) {
+	m_cache = cache;
+	if (m_cache != nullptr) {
+		m_cache->bind(criterion);
+		m_cache->invalidate(m_len);
+	}
+}
+
+void CParser::detachCache() {
+	m_cache = nullptr;
 }
 
 char *CParser::currentItemPointer() {
-	return (char*)m_buf + m_pos;
+	size_t avail;
+	return (char*)spanAt(m_pos, avail);
 }
 
 char CParser::currentItem() {
 	if (isBufferOverflow()) {
 		return '\0';
 	}
-	return (char)m_buf[m_pos];
+	return (char)itemAt(m_pos);
 }
 
 void CParser::reset() {
 	m_pos = 0;
-}
-
-inline bool CParser::isBufferOverflow() {
-	return m_pos >= m_len;
+	m_reading = false;
 }
 
 // Read methods
@@ -210,13 +346,13 @@ float CParser::readFloat(CParserCallbackFloat callback) {
 	bool isDecimalStage = false;
 
 	bool isNegative = false;
-	if (m_buf[m_pos] == '-') {
+	if (itemAt(m_pos) == '-') {
 		isNegative = true;
 		m_pos++;
 	}
 
 	while (m_pos < m_len) {
-		char incomingChar = m_buf[m_pos];
+		char incomingChar = itemAt(m_pos);
 
 		if (incomingChar == '.' || incomingChar == ',') {
 			isDecimalStage = true;
@@ -254,7 +390,7 @@ float CParser::readUnsignedFloat(CParserCallbackFloat callback) {
 	bool isDecimalStage = false;
 
 	while (m_pos < m_len) {
-		char incomingChar = m_buf[m_pos];
+		char incomingChar = itemAt(m_pos);
 
 		if (incomingChar == '.' || incomingChar == ',')
 			isDecimalStage = true;
@@ -282,6 +418,60 @@ float CParser::readUnsignedFloat(CParserCallbackFloat callback) {
 	return data;
 }
 
+// Reads a decimal number scaled by 10^scale (e.g. scale 3 returns millidegrees),
+// rounding half away from zero on the first dropped digit. Values that do not
+// fit once scaled, whatever the scale, saturate to INT32_MAX or INT32_MIN.
+int32_t CParser::readDecimal(uint8_t scale, CParserCallbackInt32 callback) {
+	bool valid = CParser::isNumeric(currentItem());
+	if (!valid) return 0;
+
+	bool isNegative = false;
+	if (itemAt(m_pos) == '-') {
+		isNegative = true;
+		m_pos++;
+	}
+
+	uint32_t limit = isNegative ? 0x80000000UL : 0x7FFFFFFFUL;
+	uint32_t data = 0;
+	uint8_t decimals = 0;
+	bool isDecimalStage = false;
+	bool roundUp = false;
+	bool dropped = false;
+
+	while (m_pos < m_len) {
+		char incomingChar = itemAt(m_pos);
+
+		if ((incomingChar == '.' || incomingChar == ',') && !isDecimalStage) {
+			isDecimalStage = true;
+		} else if (incomingChar >= '0' && incomingChar <= '9') {
+			if (!isDecimalStage || decimals < scale) {
+				data = saturatedMulAdd(data, incomingChar - '0', limit);
+				decimals += isDecimalStage ? 1 : 0;
+			} else if (!dropped) {
+				roundUp = incomingChar >= '5';
+				dropped = true;
+			}
+		} else {
+			break;
+		}
+
+		m_pos++;
+	}
+
+	for (; decimals < scale; decimals++) {
+		data = saturatedMulAdd(data, 0, limit);
+	}
+	if (roundUp && data < limit) {
+		data++;
+	}
+
+	int32_t rst = applySign(data, isNegative);
+	if (callback != nullptr) {
+		callback(rst);
+	}
+	return rst;
+}
+
 size_t CParser::readCharArray(char separator, CParserCallbackCharArray callback) {
 	return readCharArray(separator, true, callback);
 }
@@ -291,49 +481,124 @@ size_t CParser::readCharArray(CParserCriterion criterion, CParserCallbackCharArr
 }
 
 size_t CParser::readCharArray(char separator, bool endIfNotFound, CParserCallbackCharArray callback) {
-	size_t length = 0;
-	bool found = false;
+	size_t start = m_pos;
+	size_t index = find(separator, m_pos, m_len);
+	size_t length = index - start;
+	bool found = index < m_len;
 
-	char *start = currentItemPointer();
-	while (m_pos + length < m_len) {
-		if (m_buf[m_pos + length] == separator) {
-			found = true;
-			break;
-		}
-		length++;
-	}
 	m_pos += length + (found ? 1 : 0);
 
 	if ((endIfNotFound || (!endIfNotFound && found))) {
-		if (callback != nullptr) callback(start, length);
+		if (callback != nullptr) deliver(start, length, callback);
 	}
 
 	return length;
 }
 
 size_t CParser::readCharArray(CParserCriterion criterion, bool endIfNotFound, CParserCallbackCharArray callback) {
-	size_t length = 0;
-	bool found = false;
+	size_t start = m_pos;
+	size_t index = find(criterion, m_pos, m_len);
+	size_t length = index - start;
+	bool found = index < m_len;
 
-	char *start = currentItemPointer();
-	while (m_pos + length < m_len) {
-		if (criterion(m_buf[m_pos + length])) {
-			found = true;
-			break;
+	m_pos += length + (found ? 1 : 0);
+
+	if ((endIfNotFound || (!endIfNotFound && found))) {
+		if (callback != nullptr) {
+			deliver(start, length, callback);
 		}
-		length++;
 	}
+
+	return length;
+}
+
+size_t CParser::readCharArray(const CParserByteSet &set, CParserCallbackCharArray callback) {
+	return readCharArray(set, true, callback);
+}
+
+size_t CParser::readCharArray(const CParserByteSet &set, bool endIfNotFound, CParserCallbackCharArray callback) {
+	size_t start = m_pos;
+	size_t index = find(set, m_pos, m_len);
+	size_t length = index - start;
+	bool found = index < m_len;
+
 	m_pos += length + (found ? 1 : 0);
 
 	if ((endIfNotFound || (!endIfNotFound && found))) {
 		if (callback != nullptr) {
-			callback(start, length);
+			deliver(start, length, callback);
 		}
 	}
 
 	return length;
 }
 
+// Budgeted reads end like their unbudgeted forms: readCharArray consumes the
+// separator, readString leaves the cursor on it. The other methods must not
+// move the cursor while a read is in progress; begin() and reset() abandon it.
+CParserStatus CParser::readCharArray(char separator, CParserBudget &budget, CParserCallbackCharArray callback) {
+	size_t start;
+	if (scanToken((byte)separator, budget, start) == CPARSER_IN_PROGRESS) {
+		return CPARSER_IN_PROGRESS;
+	}
+	size_t length = m_pos - start;
+	next();
+	if (callback != nullptr) {
+		deliver(start, length, callback);
+	}
+	return CPARSER_DONE;
+}
+
+CParserStatus CParser::readCharArray(CParserCriterion criterion, CParserBudget &budget, CParserCallbackCharArray callback) {
+	size_t start;
+	if (scanToken(criterion, budget, start) == CPARSER_IN_PROGRESS) {
+		return CPARSER_IN_PROGRESS;
+	}
+	size_t length = m_pos - start;
+	next();
+	if (callback != nullptr) {
+		deliver(start, length, callback);
+	}
+	return CPARSER_DONE;
+}
+
+CParserStatus CParser::readCharArray(const CParserByteSet &set, CParserBudget &budget, CParserCallbackCharArray callback) {
+	size_t start;
+	if (scanToken<const CParserByteSet &>(set, budget, start) == CPARSER_IN_PROGRESS) {
+		return CPARSER_IN_PROGRESS;
+	}
+	size_t length = m_pos - start;
+	next();
+	if (callback != nullptr) {
+		deliver(start, length, callback);
+	}
+	return CPARSER_DONE;
+}
+
+CParserStatus CParser::readString(char separator, CParserBudget &budget, CParserCallbackString callback) {
+	size_t start;
+	if (scanToken((byte)separator, budget, start) == CPARSER_IN_PROGRESS) {
+		return CPARSER_IN_PROGRESS;
+	}
+	String rst = copyString(start, m_pos - start);
+	if (callback != nullptr) {
+		callback(rst);
+	}
+	return CPARSER_DONE;
+}
+
+CParserStatus CParser::readString(CParserCriterion criterion, CParserBudget &budget, CParserCallbackString callback) {
+	size_t start;
+	if (scanToken(criterion, budget, start) == CPARSER_IN_PROGRESS) {
+		return CPARSER_IN_PROGRESS;
+	}
+	String rst = copyString(start, m_pos - start);
+	if (callback != nullptr) {
+		callback(rst);
+	}
+	return CPARSER_DONE;
+}
+
 String CParser::readString(char separator, CParserCallbackString callback) {
 	return readString(separator, true, callback);
 }
@@ -344,23 +609,17 @@ String CParser::readString(CParserCriterion criterion, CParserCallbackString cal
 
 String CParser::readString(char separator, bool endIfNotFound, CParserCallbackString callback) {
 	String rst;
-	size_t length = 0;
-	bool found = false;
+	size_t start = m_pos;
+	size_t index = find(separator, m_pos, m_len);
+	size_t length = index - start;
+	bool found = index < m_len;
 
-	char *start = currentItemPointer();
-	while (m_pos + length < m_len) {
-		if (m_buf[m_pos + length] == separator) {
-			found = true;
-			break;
-		}
-		length++;
-	}
 	m_pos += length;//+ (found ? 1 : 0);
 
 	if ((endIfNotFound || (!endIfNotFound && found))) {
 		rst.reserve(length);
 		for (size_t i = 0; i < length; i++) {
-			rst.concat(start[i]);
+			rst.concat((char)itemAt(start + i));
 		}
 
 		if (callback != nullptr) {
@@ -373,24 +632,17 @@ String CParser::readString(char separator, bool endIfNotFound, CParserCallbackSt
 
 String CParser::readString(CParserCriterion criterion, bool endIfNotFound, CParserCallbackString callback) {
 	String rst;
-	size_t length = 0;
-	bool found = false;
-
-	char *start = currentItemPointer();
-	while (m_pos + length < m_len) {
-		if (criterion(m_buf[m_pos + length])) {
-			found = true;
-			break;
-		}
-		length++;
-	}
+	size_t start = m_pos;
+	size_t index = find(criterion, m_pos, m_len);
+	size_t length = index - start;
+	bool found = index < m_len;
 
 	m_pos += length;
 
 	if ((endIfNotFound || (!endIfNotFound && found))) {
 		rst.reserve(length);
 		for (size_t i = 0; i < length; i++) {
-			rst.concat(start[i]);
+			rst.concat((char)itemAt(start + i));
 		}
 
 		if (callback != nullptr) {
@@ -402,6 +654,59 @@ String CParser::readString(CParserCriterion criterion, bool endIfNotFound, CPars
 }
 
 
+// UTF-8 methods
+bool CParser::isValidUtf8() {
+	size_t index = m_pos;
+	while (index < m_len) {
+		size_t avail;
+		byte *span = spanAt(index, avail);
+		size_t length = CParserUtf8::complete(span, avail);
+		if (!CParserUtf8::validate(span, length)) {
+			return false;
+		}
+		index += length;
+		// A sequence split by the end of the span is decoded across the wrap
+		if (length < avail) {
+			if (decodeAt(index, length) == CPARSER_UTF8_INVALID) {
+				return false;
+			}
+			index += length;
+		}
+	}
+	return true;
+}
+
+size_t CParser::countCodePoints() {
+	size_t count = 0;
+	size_t index = m_pos;
+	while (index < m_len) {
+		size_t avail;
+		byte *span = spanAt(index, avail);
+		count += CParserUtf8::count(span, avail);
+		index += avail;
+	}
+	return count;
+}
+
+// Malformed sequences read as U+FFFD and advance a single byte
+uint32_t CParser::readCodePoint(CParserCallbackUint32 callback) {
+	if (isBufferOverflow()) {
+		return 0;
+	}
+
+	size_t length;
+	uint32_t data = decodeAt(m_pos, length);
+	m_pos += length;
+	if (data == CPARSER_UTF8_INVALID) {
+		data = CPARSER_UTF8_REPLACEMENT;
+	}
+
+	if (callback != nullptr) {
+		callback(data);
+	}
+	return data;
+}
+
 // compare methods
 bool CParser::compare(char token, CParserCallback callback) {
 	if (m_pos >= m_len) {
@@ -428,7 +733,7 @@ bool CParser::compare(const char token[], size_t len, CParserCallback callback)
 	}
 
 	bool found = false;
-	if (compare((char *)m_buf, token, len)) {
+	if (matches(token, len)) {
 		if (callback != nullptr) {
 			callback();
 		}
@@ -458,13 +763,11 @@ bool CParser::compare(CParserCriterion comparision, CParserCallback callback) {
 
 // search methods
 bool CParser::search(char token, CParserCallback callback) {
-	for (size_t index = m_pos; index < m_len; index++) {
-		if (m_buf[index] == token) {
-			if (callback != nullptr) {
-				callback();
-			}
-			return true;
+	if (find(token, m_pos, m_len) < m_len) {
+		if (callback != nullptr) {
+			callback();
 		}
+		return true;
 	}
 	return false;
 }
@@ -475,7 +778,7 @@ bool CParser::search(char token[], CParserCallback callback) {
 
 bool CParser::search(char token[], size_t max_length, CParserCallback callback) {
 	for (size_t index = m_pos; index < m_len; index++) {
-		if (compare((char*)m_buf, token, max_length)) {
+		if (matches(token, max_length)) {
 			if (callback != nullptr) {
 				callback();
 			}
@@ -490,13 +793,65 @@ bool CParser::search(String token, CParserCallback callback) {
 }
 
 bool CParser::search(CParserCriterion comparision, CParserCallback callback) {
-	for (size_t index = m_pos; index < m_len; index++) {
-		if (comparision(m_buf[index])) {
-			if (callback != nullptr) {
-				callback();
-			}
-			return true;
+	if (find(comparision, m_pos, m_len) < m_len) {
+		if (callback != nullptr) {
+			callback();
 		}
+		return true;
+	}
+	return false;
+}
+
+bool CParser::search(const CParserByteSet &set, CParserCallback callback) {
+	if (find(set, m_pos, m_len) < m_len) {
+		if (callback != nullptr) {
+			callback();
+		}
+		return true;
+	}
+	return false;
+}
+
+bool CParser::search(const CParserPattern &pattern, CParserCallback callback) {
+	if (pattern.find(*this, m_pos, false, nullptr)) {
+		if (callback != nullptr) {
+			callback();
+		}
+		return true;
+	}
+	return false;
+}
+
+// Fills match with the span of the leftmost-longest match and its groups
+bool CParser::search(const CParserPattern &pattern, CParserMatch &match, CParserCallback callback) {
+	if (pattern.find(*this, m_pos, false, &match.span)) {
+		pattern.capture(*this, match);
+		if (callback != nullptr) {
+			callback();
+		}
+		return true;
+	}
+	return false;
+}
+
+// Pattern methods
+bool CParser::match(const CParserPattern &pattern, CParserCallback callback) {
+	if (pattern.find(*this, m_pos, true, nullptr)) {
+		if (callback != nullptr) {
+			callback();
+		}
+		return true;
+	}
+	return false;
+}
+
+bool CParser::match(const CParserPattern &pattern, CParserMatch &match, CParserCallback callback) {
+	if (pattern.find(*this, m_pos, true, &match.span)) {
+		pattern.capture(*this, match);
+		if (callback != nullptr) {
+			callback();
+		}
+		return true;
 	}
 	return false;
 }
@@ -577,6 +932,47 @@ void CParser::doWhile(CParserCondition condition, CParserCallback callback, CPar
 	}
 }
 
+// Budgeted loops: every evaluation of the condition is one step. When the
+// budget runs out the loop returns CPARSER_IN_PROGRESS and the next call
+// resumes it; finally only runs once the loop has ended.
+CParserStatus CParser::doUntil(CParserCondition condition, CParserBudget &budget, CParserCallback callback, CParserCallback finally) {
+	while (true) {
+		if (budget.isExhausted()) {
+			return CPARSER_IN_PROGRESS;
+		}
+		budget.spend(1);
+		if (condition()) {
+			break;
+		}
+		if (callback != nullptr) {
+			callback();
+		}
+	}
+	if (finally != nullptr) {
+		finally();
+	}
+	return CPARSER_DONE;
+}
+
+CParserStatus CParser::doWhile(CParserCondition condition, CParserBudget &budget, CParserCallback callback, CParserCallback finally) {
+	while (true) {
+		if (budget.isExhausted()) {
+			return CPARSER_IN_PROGRESS;
+		}
+		budget.spend(1);
+		if (!condition()) {
+			break;
+		}
+		if (callback != nullptr) {
+			callback();
+		}
+	}
+	if (finally != nullptr) {
+		finally();
+	}
+	return CPARSER_DONE;
+}
+
 
 // skip methods
 void CParser::skip(size_t num_items) {
@@ -587,132 +983,151 @@ void CParser::skip(size_t num_items) {
 }
 
 void CParser::skipWhile(char item) {
-	while (!isBufferOverflow() && currentItem() == item) {
-		m_pos++;
+	if (!isBufferOverflow()) {
+		m_pos = findNot(item, m_pos, m_len);
 	}
 }
 
 void CParser::skipWhile(CParserCriterion comparision) {
-	while (!isBufferOverflow() && comparision(currentItem())) {
-		m_pos++;
+	if (!isBufferOverflow()) {
+		m_pos = findNot(comparision, m_pos, m_len);
 	}
 }
 
 void CParser::skipUntil(char item) {
-	while (!isBufferOverflow() && (currentItem() != item)) {
-		m_pos++;
+	if (!isBufferOverflow()) {
+		m_pos = find(item, m_pos, m_len);
 	}
 }
 
 void CParser::skipUntil(CParserCriterion comparision) {
-	while (!isBufferOverflow() && !comparision(currentItem())) {
-		m_pos++;
+	if (!isBufferOverflow()) {
+		m_pos = find(comparision, m_pos, m_len);
 	}
 }
 
-// Jump methods
-void CParser::jumpAfter(char item) {
-	size_t index = m_pos;
-	while (index < m_len) {
-		if (m_buf[index] == item) {
-			m_pos = index;
-			next();
-			return;
-		}
-		index++;
+void CParser::skipWhile(const CParserByteSet &set) {
+	if (!isBufferOverflow()) {
+		m_pos = findNot(set, m_pos, m_len);
 	}
 }
 
-void CParser::jumpAfter(CParserCriterion comparision) {
-	size_t index = m_pos;
-	while (index < m_len) {
-		if (comparision(m_buf[index])) {
-			m_pos = index;
-			next();
-			return;
-		}
-		index++;
+void CParser::skipUntil(const CParserByteSet &set) {
+	if (!isBufferOverflow()) {
+		m_pos = find(set, m_pos, m_len);
 	}
 }
 
-void CParser::jumpTo(char item) {
-	size_t index = m_pos;
-	while (index < m_len) {
-		if (m_buf[index] == item) {
-			m_pos = index;
-			return;
-		}
-		index++;
-	}
+// Budgeted skips: every byte scanned is one step and the cursor keeps the
+// progress, so an unfinished skip resumes where it stopped.
+CParserStatus CParser::skipWhile(char item, CParserBudget &budget) {
+	return scanUntil((byte)item, false, budget);
 }
 
-void CParser::jumpTo(CParserCriterion comparision) {
-	size_t index = m_pos;
-	while (index < m_len) {
-		if (comparision(m_buf[index])) {
-			m_pos = index;
-			return;
-		}
-		index++;
-	}
+CParserStatus CParser::skipWhile(CParserCriterion comparision, CParserBudget &budget) {
+	return scanUntil(comparision, false, budget);
 }
 
-//Static methods
-bool CParser::isPrintable(byte item) {
-	return item >= 32 && item < 129;
+CParserStatus CParser::skipWhile(const CParserByteSet &set, CParserBudget &budget) {
+	return scanUntil<const CParserByteSet &>(set, false, budget);
 }
 
-bool CParser::isAlfaNumeric(byte item) {
-	return isLetter(item) || isDigit(item);
+CParserStatus CParser::skipUntil(char item, CParserBudget &budget) {
+	return scanUntil((byte)item, true, budget);
 }
 
-bool CParser::isNotDigit(byte item) {
-	return !isDigit(item);
+CParserStatus CParser::skipUntil(CParserCriterion comparision, CParserBudget &budget) {
+	return scanUntil(comparision, true, budget);
 }
 
-bool CParser::isDigit(byte item) {
-	return item >= '0' && item <= '9';
+CParserStatus CParser::skipUntil(const CParserByteSet &set, CParserBudget &budget) {
+	return scanUntil<const CParserByteSet &>(set, true, budget);
 }
 
-bool CParser::isNumeric(byte item) {
-	return isDigit(item) || item == '.' || item == ',' || item == '-';
+// Jump methods
+void CParser::jumpAfter(char item) {
+	size_t index = find(item, m_pos, m_len);
+	if (index < m_len) {
+		m_pos = index;
+		next();
+	}
 }
 
-bool CParser::isLetter(byte item) {
-	return isUpperCaseLetter(item) || isLowerCaseLetter(item);
+void CParser::jumpAfter(CParserCriterion comparision) {
+	size_t index = find(comparision, m_pos, m_len);
+	if (index < m_len) {
+		m_pos = index;
+		next();
+	}
 }
 
-bool CParser::isNotLetter(byte item) {
-	return !isLetter(item);
+void CParser::jumpAfter(const CParserByteSet &set) {
+	size_t index = find(set, m_pos, m_len);
+	if (index < m_len) {
+		m_pos = index;
+		next();
+	}
 }
 
-bool CParser::isUpperCaseLetter(byte item) {
-	return item >= 'A' && item <= 'Z';
+// Budgeted jumps consume the bytes they scan: if the item is not found the
+// cursor ends at the end of the buffer instead of staying where it was.
+CParserStatus CParser::jumpAfter(char item, CParserBudget &budget) {
+	CParserStatus status = skipUntil(item, budget);
+	if (status == CPARSER_DONE) {
+		next();
+	}
+	return status;
 }
 
-bool CParser::isLowerCaseLetter(byte item) {
-	return item >= 'a' && item <= 'z';
+CParserStatus CParser::jumpAfter(CParserCriterion comparision, CParserBudget &budget) {
+	CParserStatus status = skipUntil(comparision, budget);
+	if (status == CPARSER_DONE) {
+		next();
+	}
+	return status;
 }
 
-bool CParser::isSeparator(byte item) {
-	return item = '|' || item == '.' || item == ',' || item == ';' || item == ' ' ||
-		item == '_' || item == '-' || item == '#' || item == '?' || item == '\0';
+CParserStatus CParser::jumpAfter(const CParserByteSet &set, CParserBudget &budget) {
+	CParserStatus status = skipUntil(set, budget);
+	if (status == CPARSER_DONE) {
+		next();
+	}
+	return status;
 }
 
-bool CParser::isSymbol(byte item) {
-	return isPrintable(item) && !isDigit(item) && !isLetter(item);
+void CParser::jumpTo(char item) {
+	size_t index = find(item, m_pos, m_len);
+	if (index < m_len) {
+		m_pos = index;
+	}
+}
+
+void CParser::jumpTo(CParserCriterion comparision) {
+	size_t index = find(comparision, m_pos, m_len);
+	if (index < m_len) {
+		m_pos = index;
+	}
 }
 
-bool CParser::isNewLine(byte item) {
-	return item == '\n';
+void CParser::jumpTo(const CParserByteSet &set) {
+	size_t index = find(set, m_pos, m_len);
+	if (index < m_len) {
+		m_pos = index;
+	}
 }
 
-bool CParser::isCarriageReturn(byte item) {
-	return item == '\r';
+void CParser::jumpAfter(const CParserPattern &pattern) {
+	CParserSpan span;
+	if (pattern.find(*this, m_pos, false, &span)) {
+		m_pos = span.start + span.length;
+	}
 }
 
-bool CParser::isSeparatorOrNewLine(byte item) {
-	return isSeparator(item) || isNewLine(item);
+void CParser::jumpTo(const CParserPattern &pattern) {
+	CParserSpan span;
+	if (pattern.find(*this, m_pos, false, &span)) {
+		m_pos = span.start;
+	}
 }
 
 // Private methods
@@ -722,7 +1137,7 @@ inline void CParser::next() {
 	}
 }
 
-inline bool CParser::compare(const char *str1, const char *str2, size_t n) {
+inline bool CParser::matches(const char *str, size_t n) {
 	bool equals = true;
 
 	size_t newIndex = m_pos;
@@ -732,7 +1147,7 @@ inline bool CParser::compare(const char *str1, const char *str2, size_t n) {
 			break;
 		}
 
-		if (str1[newIndex] != str2[index]) {
+		if ((char)itemAt(newIndex) != str[index]) {
 			equals = false;
 			break;
 		}
@@ -747,17 +1162,249 @@ inline bool CParser::compare(const char *str1, const char *str2, size_t n) {
 	return equals;
 }
 
+// Span scanners: return the index of the first (non) matching item in [from, to),
+// or to. Each contiguous span of a ring is scanned separately. Item and criterion
+// scans go through the token cache when one is attached and bound to them.
+size_t CParser::find(byte item, size_t from, size_t to) {
+	bool cached = m_cache != nullptr && m_cache->isBoundTo(item);
+	if (cached && m_cache->lookup(from, to)) {
+		return from;
+	}
+
+	size_t index = from;
+	while (index < to) {
+		size_t avail;
+		byte *span = spanAt(index, avail);
+		if (avail > to - index) {
+			avail = to - index;
+		}
+		byte *found = (byte *)memchr(span, item, avail);
+		if (found != nullptr) {
+			index += found - span;
+			break;
+		}
+		index += avail;
+	}
+
+	if (cached) {
+		m_cache->record(from, index, to);
+	}
+	return index;
+}
+
+size_t CParser::find(CParserCriterion criterion, size_t from, size_t to) {
+	bool cached = m_cache != nullptr && m_cache->isBoundTo(criterion);
+	if (cached && m_cache->lookup(from, to)) {
+		return from;
+	}
+
+	size_t index = from;
+	while (index < to) {
+		size_t avail;
+		byte *span = spanAt(index, avail);
+		if (avail > to - index) {
+			avail = to - index;
+		}
+		size_t offset = 0;
+		while (offset < avail && !criterion(span[offset])) {
+			offset++;
+		}
+		index += offset;
+		if (offset < avail) {
+			break;
+		}
+	}
+
+	if (cached) {
+		m_cache->record(from, index, to);
+	}
+	return index;
+}
+
+size_t CParser::findNot(byte item, size_t from, size_t to) {
+	while (from < to) {
+		size_t avail;
+		byte *span = spanAt(from, avail);
+		if (avail > to - from) {
+			avail = to - from;
+		}
+		for (size_t index = 0; index < avail; index++) {
+			if (span[index] != item) {
+				return from + index;
+			}
+		}
+		from += avail;
+	}
+	return to;
+}
+
+size_t CParser::findNot(CParserCriterion criterion, size_t from, size_t to) {
+	while (from < to) {
+		size_t avail;
+		byte *span = spanAt(from, avail);
+		if (avail > to - from) {
+			avail = to - from;
+		}
+		for (size_t index = 0; index < avail; index++) {
+			if (!criterion(span[index])) {
+				return from + index;
+			}
+		}
+		from += avail;
+	}
+	return to;
+}
+
+size_t CParser::find(const CParserByteSet &set, size_t from, size_t to) {
+	while (from < to) {
+		size_t avail;
+		byte *span = spanAt(from, avail);
+		if (avail > to - from) {
+			avail = to - from;
+		}
+		size_t index = set.find(span, avail);
+		if (index < avail) {
+			return from + index;
+		}
+		from += avail;
+	}
+	return to;
+}
+
+size_t CParser::findNot(const CParserByteSet &set, size_t from, size_t to) {
+	while (from < to) {
+		size_t avail;
+		byte *span = spanAt(from, avail);
+		if (avail > to - from) {
+			avail = to - from;
+		}
+		size_t index = set.findNot(span, avail);
+		if (index < avail) {
+			return from + index;
+		}
+		from += avail;
+	}
+	return to;
+}
+
+uint32_t CParser::decodeAt(size_t index, size_t &length) {
+	size_t avail;
+	byte *span = spanAt(index, avail);
+	if (avail >= 4 || index + avail >= m_len) {
+		return CParserUtf8::decode(span, avail, length);
+	}
+
+	byte sequence[4];
+	size_t count = 0;
+	for (; count < 4 && index + count < m_len; count++) {
+		sequence[count] = itemAt(index + count);
+	}
+	return CParserUtf8::decode(sequence, count, length);
+}
+
+void CParser::deliver(size_t from, size_t length, CParserCallbackCharArray callback) {
+	size_t avail;
+	char *span = (char *)spanAt(from, avail);
+	if (length <= avail) {
+		callback(span, length);
+		return;
+	}
+	callback(span, avail);
+	callback((char *)m_wrap, length - avail);
+}
+
+uint32_t CParser::saturatedMulAdd(uint32_t value, uint8_t digit, uint32_t limit) {
+	if (value > (limit - digit) / 10) {
+		return limit;
+	}
+	return value * 10 + digit;
+}
+
+int32_t CParser::applySign(uint32_t magnitude, bool isNegative) {
+	if (!isNegative) {
+		return (int32_t)magnitude;
+	}
+	return magnitude == 0 ? 0 : -(int32_t)(magnitude - 1) - 1;
+}
+
+// The fraction is converted from its last digit backwards, f = (f + d * 2^n) / 10,
+// with four guard bits so the final rounding is exact to well under half an LSB.
+int32_t CParser::readFixedPoint(uint8_t fracBits, CParserCallbackInt32 callback) {
+	bool valid = CParser::isNumeric(currentItem());
+	if (!valid) return 0;
+
+	bool isNegative = false;
+	if (itemAt(m_pos) == '-') {
+		isNegative = true;
+		m_pos++;
+	}
+
+	uint32_t limit = isNegative ? 0x80000000UL : 0x7FFFFFFFUL;
+	uint32_t intLimit = (limit >> fracBits) + 1;
+	uint32_t dataReal = 0;
+	size_t fracStart = 0;
+	size_t fracEnd = 0;
+	bool isDecimalStage = false;
+
+	while (m_pos < m_len) {
+		char incomingChar = itemAt(m_pos);
+
+		if ((incomingChar == '.' || incomingChar == ',') && !isDecimalStage) {
+			isDecimalStage = true;
+			fracStart = fracEnd = m_pos + 1;
+		} else if (incomingChar >= '0' && incomingChar <= '9') {
+			if (!isDecimalStage) {
+				dataReal = saturatedMulAdd(dataReal, incomingChar - '0', intLimit);
+			} else {
+				fracEnd = m_pos + 1;
+			}
+		} else {
+			break;
+		}
+
+		m_pos++;
+	}
+
+	const uint8_t guardBits = 4;
+	uint32_t dataDecimal = 0;
+	for (size_t index = fracEnd; index > fracStart; index--) {
+		uint32_t digit = itemAt(index - 1) - '0';
+		dataDecimal = (dataDecimal + (digit << (fracBits + guardBits))) / 10;
+	}
+	dataDecimal = (dataDecimal + (1UL << (guardBits - 1))) >> guardBits;
+	if (dataDecimal >> fracBits) {
+		dataReal++;
+		dataDecimal = 0;
+	}
+
+	uint32_t data;
+	if (dataReal > (limit >> fracBits)) {
+		data = limit;
+	} else {
+		data = (dataReal << fracBits) | dataDecimal;
+		if (data > limit) {
+			data = limit;
+		}
+	}
+
+	int32_t rst = applySign(data, isNegative);
+	if (callback != nullptr) {
+		callback(rst);
+	}
+	return rst;
+}
+
 template<class T_int> T_int CParser::readInteger() {
 	T_int rst = 0;
 
 	bool isNegative = false;
-	if (m_buf[m_pos] == '-') {
+	if (itemAt(m_pos) == '-') {
 		isNegative = true;
 		m_pos++;
 	}
 
 	while (m_pos < m_len) {
-		char incomingChar = m_buf[m_pos];
+		char incomingChar = itemAt(m_pos);
 		if (incomingChar >= '0' && incomingChar <= '9') {
 			rst = (rst * 10) + (incomingChar - '0');
 		} else {
@@ -772,7 +1419,7 @@ template<class T_uint> inline T_uint CParser::readUnsignedInteger() {
 	T_uint rst = 0;
 
 	while (m_pos < m_len) {
-		char incomingChar = m_buf[m_pos];
+		char incomingChar = itemAt(m_pos);
 
 		if (incomingChar >= '0' && incomingChar <= '9') {
 			rst = (rst * 10) + (incomingChar - '0');
@@ -782,4 +1429,46 @@ template<class T_uint> inline T_uint CParser::readUnsignedInteger() {
 		m_pos++;
 	}
 	return rst;
+}
+
+// Scans the token of a budgeted read up to the item, resuming from the cursor;
+// once done, start is where the first call found the cursor.
+template<class T_item> CParserStatus CParser::scanToken(T_item item, CParserBudget &budget, size_t &start) {
+	if (!m_reading) {
+		m_tokenStart = m_pos;
+		m_reading = true;
+	}
+	if (scanUntil<T_item>(item, true, budget) == CPARSER_IN_PROGRESS) {
+		return CPARSER_IN_PROGRESS;
+	}
+	m_reading = false;
+	start = m_tokenStart;
+	return CPARSER_DONE;
+}
+
+String CParser::copyString(size_t from, size_t length) {
+	String rst;
+	rst.reserve(length);
+	for (size_t i = 0; i < length; i++) {
+		rst.concat((char)itemAt(from + i));
+	}
+	return rst;
+}
+
+template<class T_item> CParserStatus CParser::scanUntil(T_item item, bool match, CParserBudget &budget) {
+	while (m_pos < m_len) {
+		size_t steps = budget.available(m_len - m_pos);
+		if (steps == 0) {
+			return CPARSER_IN_PROGRESS;
+		}
+
+		size_t limit = m_pos + steps;
+		size_t index = match ? find(item, m_pos, limit) : findNot(item, m_pos, limit);
+		budget.spend(index - m_pos + (index < limit ? 1 : 0));
+		m_pos = index;
+		if (index < limit) {
+			break;
+		}
+	}
+	return CPARSER_DONE;
 }
\ No newline at end of file
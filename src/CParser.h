@@ -53,17 +53,66 @@ typedef void(*CParserCallbackString)(String &data);
 typedef bool(*CParserCondition)();
 typedef bool(*CParserCriterion)(byte data);
 
+class CParserByteSet;
+class CParserTokenCache;
+class CParserPattern;
+struct CParserMatch;
+
+// Result of the budgeted methods: call again to resume an unfinished job
+enum CParserStatus {
+	CPARSER_DONE,
+	CPARSER_IN_PROGRESS
+};
+
+// Bytes scanned per deadline check of a time budget
+#ifndef CPARSER_BUDGET_CHUNK
+#define CPARSER_BUDGET_CHUNK 64
+#endif
+
+// Work allowed to budgeted methods in one loop() iteration, as a number of
+// steps (bytes scanned, or loop iterations of doWhile/doUntil) or as time.
+// One budget can be shared by several calls.
+class CParserBudget {
+public:
+	CParserBudget(size_t steps);
+	static CParserBudget within(uint32_t duration);
+
+	size_t available(size_t wanted);
+	void spend(size_t steps);
+	bool isExhausted();
+
+private:
+	size_t m_steps;
+	uint32_t m_start;
+	uint32_t m_duration;
+	bool m_timed;
+};
+
+// Cursor methods that can run at compile time need C++14 relaxed constexpr
+#if __cplusplus >= 201402L
+#define CPARSER_CONSTEXPR constexpr
+#else
+#define CPARSER_CONSTEXPR inline
+#endif
+
 class CParser {
 public:
 	CParser();
 	CParser(String &str);
 	CParser(char *str);
 	CParser(byte *buf, size_t len);
+	CParser(byte *base, size_t capacity, size_t head, size_t tail);
 	virtual ~CParser();
 
 	void begin(String &str);
 	void begin(char *str);
 	void begin(byte *buf, size_t len);
+	void begin(byte *base, size_t capacity, size_t head, size_t tail);
+	void begin(const CParser &source, size_t from, size_t length);
+
+	void attachCache(CParserTokenCache *cache, char separator);
+	void attachCache(CParserTokenCache *cache, CParserCriterion criterion);
+	void detachCache();
 
 	char *currentItemPointer();
 	char currentItem();
@@ -84,16 +133,35 @@ public:
 	float readFloat(CParserCallbackFloat callback = nullptr);
 	float readUnsignedFloat(CParserCallbackFloat callback = nullptr);
 
+	// Fixed point read methods, integer arithmetic only and saturated to int32_t
+	int32_t readDecimal(uint8_t scale, CParserCallbackInt32 callback = nullptr);
+	template <uint8_t FracBits> int32_t readFixed(CParserCallbackInt32 callback = nullptr);
+
 	size_t readCharArray(char separator, CParserCallbackCharArray callback = nullptr);
 	size_t readCharArray(CParserCriterion criterion, CParserCallbackCharArray callback = nullptr);
 	size_t readCharArray(char separator, bool endIfNotFound, CParserCallbackCharArray callback = nullptr);
 	size_t readCharArray(CParserCriterion criterion, bool endIfNotFound, CParserCallbackCharArray callback = nullptr);
+	size_t readCharArray(const CParserByteSet &set, CParserCallbackCharArray callback = nullptr);
+	size_t readCharArray(const CParserByteSet &set, bool endIfNotFound, CParserCallbackCharArray callback = nullptr);
 
 	String readString(char separator, CParserCallbackString callback = nullptr);
 	String readString(CParserCriterion criterion, CParserCallbackString callback = nullptr);
 	String readString(char separator, bool endIfNotFound, CParserCallbackString callback = nullptr);
 	String readString(CParserCriterion criterion, bool endIfNotFound, CParserCallbackString callback = nullptr);
 
+	// Budgeted reads keep the token start across CPARSER_IN_PROGRESS returns and
+	// hand the whole token to the callback once its end is found
+	CParserStatus readCharArray(char separator, CParserBudget &budget, CParserCallbackCharArray callback = nullptr);
+	CParserStatus readCharArray(CParserCriterion criterion, CParserBudget &budget, CParserCallbackCharArray callback = nullptr);
+	CParserStatus readCharArray(const CParserByteSet &set, CParserBudget &budget, CParserCallbackCharArray callback = nullptr);
+	CParserStatus readString(char separator, CParserBudget &budget, CParserCallbackString callback);
+	CParserStatus readString(CParserCriterion criterion, CParserBudget &budget, CParserCallbackString callback);
+
+	// UTF-8 methods, from the current position to the end of the buffer
+	bool isValidUtf8();
+	size_t countCodePoints();
+	uint32_t readCodePoint(CParserCallbackUint32 callback = nullptr);
+
 	// compare methods
 	bool compare(char token, CParserCallback callback = nullptr);
 	bool compare(const char token[], CParserCallback callback = nullptr);
@@ -107,6 +175,13 @@ public:
 	bool search(char token[], size_t max_length, CParserCallback callback = nullptr);
 	bool search(String token, CParserCallback callback = nullptr);
 	bool search(CParserCriterion criterion, CParserCallback callback = nullptr);
+	bool search(const CParserByteSet &set, CParserCallback callback = nullptr);
+	bool search(const CParserPattern &pattern, CParserCallback callback = nullptr);
+	bool search(const CParserPattern &pattern, CParserMatch &match, CParserCallback callback = nullptr);
+
+	// Pattern methods, anchored at the current position
+	bool match(const CParserPattern &pattern, CParserCallback callback = nullptr);
+	bool match(const CParserPattern &pattern, CParserMatch &match, CParserCallback callback = nullptr);
 
 	// Loop-if methods
 	bool ifCurrentIs(char token, CParserCallback yesCallback = nullptr, CParserCallback noCallback = nullptr);
@@ -115,6 +190,8 @@ public:
 	bool IfCurrentIsNot(CParserCriterion criterion, CParserCallback yesCallback = nullptr, CParserCallback noCallback = nullptr);
 	void doUntil(CParserCondition condition, CParserCallback callback = nullptr, CParserCallback finally = nullptr);
 	void doWhile(CParserCondition condition, CParserCallback callback = nullptr, CParserCallback finally = nullptr);
+	CParserStatus doUntil(CParserCondition condition, CParserBudget &budget, CParserCallback callback = nullptr, CParserCallback finally = nullptr);
+	CParserStatus doWhile(CParserCondition condition, CParserBudget &budget, CParserCallback callback = nullptr, CParserCallback finally = nullptr);
 
 	// skip methods
 	void skip(size_t num_items);
@@ -122,38 +199,180 @@ public:
 	void skipWhile(CParserCriterion comparision);
 	void skipUntil(char item);
 	void skipUntil(CParserCriterion comparision);
+	void skipWhile(const CParserByteSet &set);
+	void skipUntil(const CParserByteSet &set);
+	CParserStatus skipWhile(char item, CParserBudget &budget);
+	CParserStatus skipWhile(CParserCriterion comparision, CParserBudget &budget);
+	CParserStatus skipWhile(const CParserByteSet &set, CParserBudget &budget);
+	CParserStatus skipUntil(char item, CParserBudget &budget);
+	CParserStatus skipUntil(CParserCriterion comparision, CParserBudget &budget);
+	CParserStatus skipUntil(const CParserByteSet &set, CParserBudget &budget);
 
 	// Jump methods
 	void jumpAfter(char item);
 	void jumpAfter(CParserCriterion comparision);
 	void jumpTo(char item);
 	void jumpTo(CParserCriterion comparision);
+	void jumpAfter(const CParserByteSet &set);
+	void jumpTo(const CParserByteSet &set);
+	void jumpAfter(const CParserPattern &pattern);
+	void jumpTo(const CParserPattern &pattern);
+	CParserStatus jumpAfter(char item, CParserBudget &budget);
+	CParserStatus jumpAfter(CParserCriterion comparision, CParserBudget &budget);
+	CParserStatus jumpAfter(const CParserByteSet &set, CParserBudget &budget);
 
 	// Comparision static methods
-	static bool isPrintable(byte item);
-	static bool isAlfaNumeric(byte Item);
-	static bool isNotDigit(byte Item);
-	static bool isDigit(byte item);
-	static bool isNumeric(byte item);
-	static bool isLetter(byte item);
-	static bool isNotLetter(byte item);
-	static bool isUpperCaseLetter(byte item);
-	static bool isLowerCaseLetter(byte item);
-	static bool isSymbol(byte item);
-	static bool isSeparator(byte item);
-	static bool isNewLine(byte item);
-	static bool isCarriageReturn(byte item);
-	static bool isSeparatorOrNewLine(byte item);
+	static constexpr bool isPrintable(byte item);
+	static constexpr bool isAlfaNumeric(byte Item);
+	static constexpr bool isNotDigit(byte Item);
+	static constexpr bool isDigit(byte item);
+	static constexpr bool isNumeric(byte item);
+	static constexpr bool isLetter(byte item);
+	static constexpr bool isNotLetter(byte item);
+	static constexpr bool isUpperCaseLetter(byte item);
+	static constexpr bool isLowerCaseLetter(byte item);
+	static constexpr bool isSymbol(byte item);
+	static constexpr bool isSeparator(byte item);
+	static constexpr bool isNewLine(byte item);
+	static constexpr bool isCarriageReturn(byte item);
+	static constexpr bool isSeparatorOrNewLine(byte item);
+	static constexpr bool isUtf8(byte item);
+	static constexpr bool isUtf8Lead(byte item);
+	static constexpr bool isUtf8Continuation(byte item);
+	static constexpr bool isAlfaNumericUtf8(byte item);
 
 private:
 	byte *m_buf;
+	byte *m_wrap;
+	size_t m_split;
 	size_t m_pos;
 	size_t m_len;
+	size_t m_tokenStart;
+	bool m_reading;
+	CParserTokenCache *m_cache;
 	inline void next();
-	inline bool compare(const char *str1, const char *str2, size_t n);
+	inline bool matches(const char *str, size_t n);
+	inline byte itemAt(size_t index);
+	inline byte *spanAt(size_t index, size_t &avail);
+	size_t find(byte item, size_t from, size_t to);
+	size_t find(CParserCriterion criterion, size_t from, size_t to);
+	size_t findNot(byte item, size_t from, size_t to);
+	size_t findNot(CParserCriterion criterion, size_t from, size_t to);
+	size_t find(const CParserByteSet &set, size_t from, size_t to);
+	size_t findNot(const CParserByteSet &set, size_t from, size_t to);
+	void deliver(size_t from, size_t length, CParserCallbackCharArray callback);
+	uint32_t decodeAt(size_t index, size_t &length);
 
 	template <class T_int> T_int readInteger();
 	template <class T_uint> T_uint readUnsignedInteger();
+	template <class T_item> CParserStatus scanUntil(T_item item, bool match, CParserBudget &budget);
+	template <class T_item> CParserStatus scanToken(T_item item, CParserBudget &budget, size_t &start);
+	String copyString(size_t from, size_t length);
+	int32_t readFixedPoint(uint8_t fracBits, CParserCallbackInt32 callback);
+	static uint32_t saturatedMulAdd(uint32_t value, uint8_t digit, uint32_t limit);
+	static int32_t applySign(uint32_t magnitude, bool isNegative);
+
+	friend class CParserJson;
+	friend class CParserKeyIndex;
+	friend class CParserPattern;
 };
 
+inline bool CParser::isBufferOverflow() {
+	return m_pos >= m_len;
+}
+
+inline byte CParser::itemAt(size_t index) {
+	return index < m_split ? m_buf[index] : m_wrap[index - m_split];
+}
+
+inline byte *CParser::spanAt(size_t index, size_t &avail) {
+	if (index < m_split) {
+		avail = m_split - index;
+		return m_buf + index;
+	}
+	avail = m_len > index ? m_len - index : 0;
+	return m_wrap + (index - m_split);
+}
+
+// Q(31-FracBits).FracBits reader, e.g. readFixed<16>() for Q16.16
+template <uint8_t FracBits> int32_t CParser::readFixed(CParserCallbackInt32 callback) {
+	static_assert(FracBits <= 24, "CParser::readFixed supports up to 24 fractional bits");
+	return readFixedPoint(FracBits, callback);
+}
+
+// Comparision static methods
+constexpr bool CParser::isPrintable(byte item) {
+	return item >= 32 && item < 129;
+}
+
+constexpr bool CParser::isAlfaNumeric(byte item) {
+	return isLetter(item) || isDigit(item);
+}
+
+constexpr bool CParser::isNotDigit(byte item) {
+	return !isDigit(item);
+}
+
+constexpr bool CParser::isDigit(byte item) {
+	return item >= '0' && item <= '9';
+}
+
+constexpr bool CParser::isNumeric(byte item) {
+	return isDigit(item) || item == '.' || item == ',' || item == '-';
+}
+
+constexpr bool CParser::isLetter(byte item) {
+	return isUpperCaseLetter(item) || isLowerCaseLetter(item);
+}
+
+constexpr bool CParser::isNotLetter(byte item) {
+	return !isLetter(item);
+}
+
+constexpr bool CParser::isUpperCaseLetter(byte item) {
+	return item >= 'A' && item <= 'Z';
+}
+
+constexpr bool CParser::isLowerCaseLetter(byte item) {
+	return item >= 'a' && item <= 'z';
+}
+
+constexpr bool CParser::isSeparator(byte item) {
+	return item == '|' || item == '.' || item == ',' || item == ';' || item == ' ' ||
+		item == '_' || item == '-' || item == '#' || item == '?' || item == '\0';
+}
+
+constexpr bool CParser::isSymbol(byte item) {
+	return isPrintable(item) && !isDigit(item) && !isLetter(item);
+}
+
+constexpr bool CParser::isNewLine(byte item) {
+	return item == '\n';
+}
+
+constexpr bool CParser::isCarriageReturn(byte item) {
+	return item == '\r';
+}
+
+constexpr bool CParser::isSeparatorOrNewLine(byte item) {
+	return isSeparator(item) || isNewLine(item);
+}
+
+constexpr bool CParser::isUtf8(byte item) {
+	return item >= 0x80;
+}
+
+constexpr bool CParser::isUtf8Lead(byte item) {
+	return item >= 0xC0;
+}
+
+constexpr bool CParser::isUtf8Continuation(byte item) {
+	return (item & 0xC0) == 0x80;
+}
+
+// Keeps multibyte sequences (accented letters, ...) inside alphanumeric tokens
+constexpr bool CParser::isAlfaNumericUtf8(byte item) {
+	return isAlfaNumeric(item) || isUtf8(item);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,199 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserByteSet.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Set of bytes for multi-delimiter scanning. On SSSE3/AVX2 and AArch64
+ *           NEON 16 or 32 bytes are classified per step with nibble lookups.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserByteSet.h"
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#elif defined(CPARSER_BYTESET_SIMD)
+#include <arm_neon.h>
+#endif
+
+#ifdef CPARSER_BYTESET_SIMD
+// Indexed by high nibble: the bit the low nibble tables use for it
+static const byte highBits[16] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static const byte highBitsUpper[16] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+};
+#endif
+
+CParserByteSet::CParserByteSet() {
+	clear();
+}
+
+CParserByteSet::CParserByteSet(const char *items) {
+	clear();
+	add(items);
+}
+
+CParserByteSet::CParserByteSet(const byte *items, size_t len) {
+	clear();
+	for (size_t index = 0; index < len; index++) {
+		add(items[index]);
+	}
+}
+
+CParserByteSet::CParserByteSet(CParserCriterion criterion) {
+	clear();
+	for (int item = 0; item < 256; item++) {
+		if (criterion(item)) {
+			add(item);
+		}
+	}
+}
+
+void CParserByteSet::add(byte item) {
+	m_bits[item >> 3] |= 1 << (item & 7);
+#ifdef CPARSER_BYTESET_SIMD
+	if (item < 0x80) {
+		m_low[item & 0x0F] |= 1 << (item >> 4);
+	} else {
+		m_lowUpper[item & 0x0F] |= 1 << ((item >> 4) - 8);
+		m_upper = true;
+	}
+#endif
+}
+
+void CParserByteSet::add(const char *items) {
+	while (*items != '\0') {
+		add(*items++);
+	}
+}
+
+bool CParserByteSet::contains(byte item) const {
+	return m_bits[item >> 3] & (1 << (item & 7));
+}
+
+size_t CParserByteSet::find(const byte *buf, size_t len) const {
+	return scan(buf, len, true);
+}
+
+size_t CParserByteSet::findNot(const byte *buf, size_t len) const {
+	return scan(buf, len, false);
+}
+
+// Private methods
+void CParserByteSet::clear() {
+	memset(m_bits, 0, sizeof(m_bits));
+#ifdef CPARSER_BYTESET_SIMD
+	memset(m_low, 0, sizeof(m_low));
+	memset(m_lowUpper, 0, sizeof(m_lowUpper));
+	m_upper = false;
+#endif
+}
+
+// A byte is a member when the bit its high nibble selects is set in the entry
+// its low nibble selects: two table lookups classify a whole vector at once.
+size_t CParserByteSet::scan(const byte *buf, size_t len, bool member) const {
+	size_t index = 0;
+
+#if defined(__AVX2__)
+	const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)m_low));
+	const __m256i lowUpper = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)m_lowUpper));
+	const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)highBits));
+	const __m256i highUpper = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)highBitsUpper));
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const uint32_t invert = member ? 0 : 0xFFFFFFFF;
+
+	for (; index + 32 <= len; index += 32) {
+		__m256i data = _mm256_loadu_si256((const __m256i *)(buf + index));
+		__m256i lo = _mm256_and_si256(data, nibble);
+		__m256i hi = _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble);
+		__m256i hits = _mm256_and_si256(_mm256_shuffle_epi8(low, lo), _mm256_shuffle_epi8(high, hi));
+		if (m_upper) {
+			hits = _mm256_or_si256(hits,
+				_mm256_and_si256(_mm256_shuffle_epi8(lowUpper, lo), _mm256_shuffle_epi8(highUpper, hi)));
+		}
+		uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hits, _mm256_setzero_si256())) ^ invert;
+		if (mask != 0) {
+			return index + __builtin_ctz(mask);
+		}
+	}
+#endif
+
+#if defined(__SSSE3__)
+	const __m128i low128 = _mm_loadu_si128((const __m128i *)m_low);
+	const __m128i lowUpper128 = _mm_loadu_si128((const __m128i *)m_lowUpper);
+	const __m128i high128 = _mm_loadu_si128((const __m128i *)highBits);
+	const __m128i highUpper128 = _mm_loadu_si128((const __m128i *)highBitsUpper);
+	const __m128i nibble128 = _mm_set1_epi8(0x0F);
+	const uint32_t invert128 = member ? 0 : 0xFFFF;
+
+	for (; index + 16 <= len; index += 16) {
+		__m128i data = _mm_loadu_si128((const __m128i *)(buf + index));
+		__m128i lo = _mm_and_si128(data, nibble128);
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(data, 4), nibble128);
+		__m128i hits = _mm_and_si128(_mm_shuffle_epi8(low128, lo), _mm_shuffle_epi8(high128, hi));
+		if (m_upper) {
+			hits = _mm_or_si128(hits,
+				_mm_and_si128(_mm_shuffle_epi8(lowUpper128, lo), _mm_shuffle_epi8(highUpper128, hi)));
+		}
+		uint32_t mask = (~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(hits, _mm_setzero_si128())) & 0xFFFF) ^ invert128;
+		if (mask != 0) {
+			return index + __builtin_ctz(mask);
+		}
+	}
+#elif defined(CPARSER_BYTESET_SIMD)
+	const uint8x16_t low = vld1q_u8(m_low);
+	const uint8x16_t lowUpper = vld1q_u8(m_lowUpper);
+	const uint8x16_t high = vld1q_u8(highBits);
+	const uint8x16_t highUpper = vld1q_u8(highBitsUpper);
+	const uint8x16_t nibble = vdupq_n_u8(0x0F);
+
+	for (; index + 16 <= len; index += 16) {
+		uint8x16_t data = vld1q_u8(buf + index);
+		uint8x16_t lo = vandq_u8(data, nibble);
+		uint8x16_t hi = vshrq_n_u8(data, 4);
+		uint8x16_t hits = vandq_u8(vqtbl1q_u8(low, lo), vqtbl1q_u8(high, hi));
+		if (m_upper) {
+			hits = vorrq_u8(hits, vandq_u8(vqtbl1q_u8(lowUpper, lo), vqtbl1q_u8(highUpper, hi)));
+		}
+		uint8x16_t found = vtstq_u8(hits, hits);
+		if (!member) {
+			found = vmvnq_u8(found);
+		}
+		// Narrow to four bits per byte to get a scalar mask
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(found), 4)), 0);
+		if (mask != 0) {
+			return index + (__builtin_ctzll(mask) >> 2);
+		}
+	}
+#endif
+
+	for (; index < len; index++) {
+		if (contains(buf[index]) == member) {
+			return index;
+		}
+	}
+	return len;
+}
@@ -0,0 +1,67 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserByteSet.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Set of bytes for multi-delimiter scanning. On SSSE3/AVX2 and AArch64
+ *           NEON 16 or 32 bytes are classified per step with nibble lookups.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserByteSet_h_
+#define _CParserByteSet_h_
+
+#include "CParser.h"
+
+#if defined(__SSSE3__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define CPARSER_BYTESET_SIMD
+#endif
+
+class CParserByteSet {
+public:
+	CParserByteSet();
+	CParserByteSet(const char *items);
+	CParserByteSet(const byte *items, size_t len);
+	CParserByteSet(CParserCriterion criterion);
+
+	void add(byte item);
+	void add(const char *items);
+	bool contains(byte item) const;
+
+	// Index of the first item of buf that is (not) in the set, or len
+	size_t find(const byte *buf, size_t len) const;
+	size_t findNot(const byte *buf, size_t len) const;
+
+private:
+	byte m_bits[32];
+#ifdef CPARSER_BYTESET_SIMD
+	// Indexed by low nibble: one bit per high nibble 0-7 and 8-15
+	byte m_low[16];
+	byte m_lowUpper[16];
+	bool m_upper;
+#endif
+
+	void clear();
+	size_t scan(const byte *buf, size_t len, bool member) const;
+};
+
+#endif
@@ -0,0 +1,588 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserJson.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : On-demand JSON reader over the CParser buffer and cursor. No DOM and
+ *           no String allocations: memory is bounded by the nesting depth.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserJson.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define CPARSER_JSON_NONE ((size_t)-1)
+
+CParserJson::CParserJson(CParser &parser) : m_parser(parser) {
+	m_value = CPARSER_JSON_NONE;
+	m_depth = 0;
+	m_mask = 0;
+	m_blockPos = 0;
+	m_blockEnd = 0;
+	m_inString = false;
+	m_escaped = false;
+}
+
+// Navigation methods
+bool CParserJson::enterObject() {
+	return enter('{');
+}
+
+bool CParserJson::enterArray() {
+	return enter('[');
+}
+
+// Looks the key up among the members of the current object and leaves the
+// cursor at its value. Keys after the cursor are tried first, then the scan
+// wraps to the start of the object; on a miss the cursor does not move.
+bool CParserJson::findKey(const char *key) {
+	if (m_depth == 0) {
+		return false;
+	}
+	skipConsumed();
+
+	size_t origin = m_parser.m_pos;
+	if (nextMember(key, CPARSER_JSON_NONE)) {
+		return true;
+	}
+	m_parser.m_pos = m_starts[m_depth - 1];
+	if (nextMember(key, origin)) {
+		return true;
+	}
+	m_parser.m_pos = origin;
+	return false;
+}
+
+// Moves to the next array element; an element left unread is skipped first
+bool CParserJson::nextElement() {
+	if (m_depth == 0) {
+		return false;
+	}
+	skipConsumed();
+	skipSpace();
+
+	char item = m_parser.currentItem();
+	if (item == ',') {
+		m_parser.m_pos++;
+		skipSpace();
+		item = m_parser.currentItem();
+	}
+	if (item == ']' || item == '}' || m_parser.isBufferOverflow()) {
+		return false;
+	}
+	m_value = m_parser.m_pos;
+	return true;
+}
+
+// Skips what is left of the current container, past its closing bracket
+bool CParserJson::leave() {
+	if (m_depth == 0) {
+		return false;
+	}
+
+	size_t level = 1;
+	size_t index = m_parser.m_pos;
+	while ((index = nextStructural(index)) < m_parser.m_len) {
+		char item = m_parser.itemAt(index);
+		if (item == '{' || item == '[') {
+			level++;
+		} else if (item == '}' || item == ']') {
+			if (--level == 0) {
+				break;
+			}
+		}
+		index++;
+	}
+
+	m_parser.m_pos = index < m_parser.m_len ? index + 1 : m_parser.m_len;
+	m_depth--;
+	m_value = CPARSER_JSON_NONE;
+	return true;
+}
+
+void CParserJson::skipValue() {
+	skipSpace();
+	char item = m_parser.currentItem();
+
+	if (item == '{' || item == '[') {
+		size_t level = 0;
+		size_t index = m_parser.m_pos;
+		while ((index = nextStructural(index)) < m_parser.m_len) {
+			item = m_parser.itemAt(index);
+			if (item == '{' || item == '[') {
+				level++;
+			} else if ((item == '}' || item == ']') && --level == 0) {
+				break;
+			}
+			index++;
+		}
+		m_parser.m_pos = index < m_parser.m_len ? index + 1 : m_parser.m_len;
+	} else if (item == '"') {
+		size_t index = closingQuote(m_parser.m_pos);
+		m_parser.m_pos = index < m_parser.m_len ? index + 1 : m_parser.m_len;
+	} else {
+		m_parser.m_pos = nextStructural(m_parser.m_pos);
+	}
+}
+
+uint8_t CParserJson::depth() {
+	return m_depth;
+}
+
+// Read methods
+bool CParserJson::isNull() {
+	skipSpace();
+	return m_parser.compare("null");
+}
+
+bool CParserJson::readBool() {
+	skipSpace();
+	if (m_parser.compare("true")) {
+		return true;
+	}
+	m_parser.compare("false");
+	return false;
+}
+
+int32_t CParserJson::readInt32() {
+	skipSpace();
+	return m_parser.readInt32();
+}
+
+uint32_t CParserJson::readUnsignedInt32() {
+	skipSpace();
+	return m_parser.readUnsignedInt32();
+}
+
+// Reads the number scaled by 10^scale, exponent included, rounding half away
+// from zero on the first dropped digit and saturating like CParser::readDecimal
+int32_t CParserJson::readDecimal(uint8_t scale) {
+	skipSpace();
+	size_t first, point, end;
+	int16_t exponent;
+	size_t next = scanNumber(first, point, end, exponent);
+	if (next == m_parser.m_pos) {
+		return 0;
+	}
+
+	bool isNegative = first > m_parser.m_pos;
+	uint32_t limit = isNegative ? 0x80000000UL : 0x7FFFFFFFUL;
+	int32_t shift = (int32_t)scale + exponent;
+	int32_t power = (int32_t)(point - first) - 1;
+	uint32_t data = 0;
+	bool roundUp = false;
+
+	for (size_t index = first; index < end; index++) {
+		if (index == point) {
+			continue;
+		}
+		byte digit = m_parser.itemAt(index) - '0';
+		if (power + shift >= 0) {
+			data = CParser::saturatedMulAdd(data, digit, limit);
+		} else if (power + shift == -1) {
+			roundUp = digit >= 5;
+		}
+		power--;
+	}
+	for (int32_t pad = power + 1 + shift; pad > 0 && data != 0 && data < limit; pad--) {
+		data = CParser::saturatedMulAdd(data, 0, limit);
+	}
+	if (roundUp && data < limit) {
+		data++;
+	}
+
+	m_parser.m_pos = next;
+	return CParser::applySign(data, isNegative);
+}
+
+// Reads the number, exponent included, from its first 9 significant digits
+float CParserJson::readFloat() {
+	skipSpace();
+	size_t first, point, end;
+	int16_t exponent;
+	size_t next = scanNumber(first, point, end, exponent);
+	if (next == m_parser.m_pos) {
+		return 0;
+	}
+
+	uint32_t mantissa = 0;
+	uint8_t digits = 0;
+	int32_t power = (int32_t)(point - first) + exponent;
+	for (size_t index = first; index < end && digits < 9; index++) {
+		if (index == point) {
+			continue;
+		}
+		mantissa = mantissa * 10 + (m_parser.itemAt(index) - '0');
+		digits += mantissa != 0 ? 1 : 0;
+		power--;
+	}
+
+	// Beyond these powers the result is zero or infinite anyway; the factors
+	// stay finite so that a zero mantissa gives zero
+	if (power > 40) {
+		power = 40;
+	} else if (power < -60) {
+		power = -60;
+	}
+	float data = mantissa;
+	while (power != 0) {
+		int32_t step = power < -30 ? -30 : (power > 30 ? 30 : power);
+		float factor = 1;
+		for (int32_t count = step < 0 ? -step : step; count > 0; count--) {
+			factor *= 10;
+		}
+		data = step < 0 ? data / factor : data * factor;
+		power -= step;
+	}
+
+	bool isNegative = first > m_parser.m_pos;
+	m_parser.m_pos = next;
+	return isNegative ? -data : data;
+}
+
+// Copies the unescaped string into dst, always NUL terminated and truncated
+// to size - 1 bytes. \u escapes are stored as UTF-8. Returns the copied length.
+size_t CParserJson::readString(char *dst, size_t size) {
+	skipSpace();
+	if (m_parser.currentItem() != '"') {
+		if (size > 0) {
+			dst[0] = '\0';
+		}
+		return 0;
+	}
+
+	size_t end = closingQuote(m_parser.m_pos);
+	size_t index = m_parser.m_pos + 1;
+	size_t length = 0;
+
+	while (index < end) {
+		byte encoded[4];
+		uint8_t count = 1;
+
+		encoded[0] = m_parser.itemAt(index++);
+		if (encoded[0] == '\\' && index < end) {
+			byte item = m_parser.itemAt(index++);
+			switch (item) {
+			case 'b': encoded[0] = '\b'; break;
+			case 'f': encoded[0] = '\f'; break;
+			case 'n': encoded[0] = '\n'; break;
+			case 'r': encoded[0] = '\r'; break;
+			case 't': encoded[0] = '\t'; break;
+			case 'u': {
+				uint32_t codePoint = readHex(index, end);
+				if (codePoint >= 0xD800 && codePoint < 0xDC00 && index + 6 <= end &&
+					m_parser.itemAt(index) == '\\' && m_parser.itemAt(index + 1) == 'u') {
+					size_t next = index + 2;
+					uint32_t low = readHex(next, end);
+					if (low >= 0xDC00 && low < 0xE000) {
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+						index = next;
+					}
+				}
+				count = encodeUtf8(codePoint, encoded);
+				break;
+			}
+			default: encoded[0] = item; break;
+			}
+		}
+
+		if (length + count >= size) {
+			break;
+		}
+		memcpy(dst + length, encoded, count);
+		length += count;
+	}
+
+	if (size > 0) {
+		dst[length] = '\0';
+	}
+	m_parser.m_pos = end < m_parser.m_len ? end + 1 : m_parser.m_len;
+	return length;
+}
+
+// Private methods
+
+// Splits the number at the cursor: its digits run from first to end, with the
+// decimal point at point (end when there is none), followed by the exponent.
+// Returns the index past the number, or the cursor when there is no number.
+size_t CParserJson::scanNumber(size_t &first, size_t &point, size_t &end, int16_t &exponent) {
+	size_t index = m_parser.m_pos;
+	if (index < m_parser.m_len && m_parser.itemAt(index) == '-') {
+		index++;
+	}
+	first = index;
+	if (index >= m_parser.m_len || !CParser::isDigit(m_parser.itemAt(index))) {
+		return m_parser.m_pos;
+	}
+
+	while (index < m_parser.m_len && CParser::isDigit(m_parser.itemAt(index))) {
+		index++;
+	}
+	point = index;
+	if (index < m_parser.m_len && m_parser.itemAt(index) == '.') {
+		index++;
+		while (index < m_parser.m_len && CParser::isDigit(m_parser.itemAt(index))) {
+			index++;
+		}
+	}
+	end = index;
+
+	exponent = 0;
+	if (index < m_parser.m_len && (m_parser.itemAt(index) == 'e' || m_parser.itemAt(index) == 'E')) {
+		index++;
+		bool isNegative = false;
+		if (index < m_parser.m_len && (m_parser.itemAt(index) == '-' || m_parser.itemAt(index) == '+')) {
+			isNegative = m_parser.itemAt(index) == '-';
+			index++;
+		}
+		while (index < m_parser.m_len && CParser::isDigit(m_parser.itemAt(index))) {
+			if (exponent < 1000) {
+				exponent = exponent * 10 + (m_parser.itemAt(index) - '0');
+			}
+			index++;
+		}
+		exponent = isNegative ? -exponent : exponent;
+	}
+	return index;
+}
+
+bool CParserJson::enter(char open) {
+	skipSpace();
+	if (m_depth >= CPARSER_JSON_DEPTH || m_parser.currentItem() != open) {
+		return false;
+	}
+	m_parser.m_pos++;
+	m_starts[m_depth++] = m_parser.m_pos;
+	m_value = CPARSER_JSON_NONE;
+	return true;
+}
+
+// Walks the members from the cursor until the end of the object or until
+// the member starting at stop. Returns with the cursor at the matching value.
+bool CParserJson::nextMember(const char *key, size_t stop) {
+	while (true) {
+		skipSpace();
+		if (m_parser.m_pos >= stop) {
+			return false;
+		}
+
+		char item = m_parser.currentItem();
+		if (item == ',') {
+			m_parser.m_pos++;
+			skipSpace();
+			item = m_parser.currentItem();
+		}
+		if (item != '"') {
+			return false;
+		}
+
+		size_t keyEnd = closingQuote(m_parser.m_pos);
+		bool found = keyEquals(m_parser.m_pos + 1, keyEnd, key);
+		m_parser.m_pos = keyEnd + 1;
+		skipSpace();
+		if (m_parser.currentItem() != ':') {
+			return false;
+		}
+		m_parser.m_pos++;
+		skipSpace();
+
+		if (found) {
+			m_value = m_parser.m_pos;
+			return true;
+		}
+		skipValue();
+	}
+}
+
+void CParserJson::skipSpace() {
+	while (!m_parser.isBufferOverflow()) {
+		byte item = m_parser.itemAt(m_parser.m_pos);
+		if (item != ' ' && item != '\t' && item != '\n' && item != '\r') {
+			break;
+		}
+		m_parser.m_pos++;
+	}
+}
+
+// Moves past the value last found, even when a read stopped inside it (e.g.
+// readInt32 on 1.5); containers count as consumed once entered.
+void CParserJson::skipConsumed() {
+	skipSpace();
+	if (m_value != CPARSER_JSON_NONE) {
+		char item = m_parser.itemAt(m_value);
+		if (m_parser.m_pos == m_value || (item != '{' && item != '[')) {
+			m_parser.m_pos = m_value;
+			skipValue();
+		}
+	}
+	m_value = CPARSER_JSON_NONE;
+}
+
+// Index of the next structural character (quote, bracket, colon or comma
+// outside strings) at or after from. From must not be inside a string unless
+// it continues the block just classified.
+size_t CParserJson::nextStructural(size_t from) {
+	while (from < m_parser.m_len) {
+		if (from < m_blockPos || from > m_blockEnd) {
+			m_inString = false;
+			m_escaped = false;
+			classify(from);
+		} else if (from == m_blockEnd) {
+			classify(from);
+		}
+
+		uint64_t bits = m_mask >> (from - m_blockPos);
+		if (bits != 0) {
+			return from + __builtin_ctzll(bits);
+		}
+		from = m_blockEnd;
+	}
+	return m_parser.m_len;
+}
+
+// Builds the structural mask of the 64 bytes at from, simdjson style: quotes
+// not escaped by a backslash are found first, a prefix xor turns them into
+// an in-string mask and the other structural characters inside are dropped.
+void CParserJson::classify(size_t from) {
+	size_t count = m_parser.m_len - from;
+	if (count > 64) {
+		count = 64;
+	}
+
+	size_t avail;
+	const byte *data = m_parser.spanAt(from, avail);
+	byte block[64];
+	if (avail < 64) {
+		for (size_t index = 0; index < count; index++) {
+			block[index] = m_parser.itemAt(from + index);
+		}
+		memset(block + count, ' ', 64 - count);
+		data = block;
+	}
+
+	uint64_t quotes = 0;
+	uint64_t backslashes = 0;
+	uint64_t operators = 0;
+#if defined(__SSE2__)
+	for (uint8_t offset = 0; offset < 64; offset += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i *)(data + offset));
+		__m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+		__m128i ops = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))),
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+		quotes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << offset;
+		backslashes |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << offset;
+		operators |= (uint64_t)(uint16_t)_mm_movemask_epi8(ops) << offset;
+	}
+#else
+	for (uint8_t index = 0; index < 64; index++) {
+		uint64_t bit = (uint64_t)1 << index;
+		switch (data[index]) {
+		case '"': quotes |= bit; break;
+		case '\\': backslashes |= bit; break;
+		case '{': case '}': case '[': case ']': case ':': case ',': operators |= bit; break;
+		}
+	}
+#endif
+
+	if (backslashes != 0 || m_escaped) {
+		uint64_t escaped = 0;
+		bool pending = m_escaped;
+		for (uint8_t index = 0; index < count; index++) {
+			uint64_t bit = (uint64_t)1 << index;
+			if (pending) {
+				escaped |= bit;
+				pending = false;
+			} else if (backslashes & bit) {
+				pending = true;
+			}
+		}
+		m_escaped = pending;
+		quotes &= ~escaped;
+	}
+
+	uint64_t inString = quotes;
+	inString ^= inString << 1;
+	inString ^= inString << 2;
+	inString ^= inString << 4;
+	inString ^= inString << 8;
+	inString ^= inString << 16;
+	inString ^= inString << 32;
+	if (m_inString) {
+		inString = ~inString;
+	}
+	m_inString = (inString >> 63) != 0;
+
+	m_mask = (operators & ~inString) | quotes;
+	m_blockPos = from;
+	m_blockEnd = from + count;
+}
+
+// The opening quote is looked up first so the block holding it is classified
+// from outside the string, wherever the cursor came from.
+size_t CParserJson::closingQuote(size_t open) {
+	return nextStructural(nextStructural(open) + 1);
+}
+
+uint32_t CParserJson::readHex(size_t &index, size_t end) {
+	uint32_t value = 0;
+	for (uint8_t digit = 0; digit < 4 && index < end; digit++) {
+		byte item = m_parser.itemAt(index++);
+		value = (value << 4) | (CParser::isDigit(item) ? item - '0' : ((item | 0x20) - 'a' + 10) & 0x0F);
+	}
+	return value;
+}
+
+uint8_t CParserJson::encodeUtf8(uint32_t codePoint, byte *dst) {
+	if (codePoint < 0x80) {
+		dst[0] = codePoint;
+		return 1;
+	}
+	if (codePoint < 0x800) {
+		dst[0] = 0xC0 | (codePoint >> 6);
+		dst[1] = 0x80 | (codePoint & 0x3F);
+		return 2;
+	}
+	if (codePoint < 0x10000) {
+		dst[0] = 0xE0 | (codePoint >> 12);
+		dst[1] = 0x80 | ((codePoint >> 6) & 0x3F);
+		dst[2] = 0x80 | (codePoint & 0x3F);
+		return 3;
+	}
+	dst[0] = 0xF0 | (codePoint >> 18);
+	dst[1] = 0x80 | ((codePoint >> 12) & 0x3F);
+	dst[2] = 0x80 | ((codePoint >> 6) & 0x3F);
+	dst[3] = 0x80 | (codePoint & 0x3F);
+	return 4;
+}
+
+bool CParserJson::keyEquals(size_t from, size_t to, const char *key) {
+	for (size_t index = from; index < to; index++) {
+		if (*key == '\0' || (char)m_parser.itemAt(index) != *key++) {
+			return false;
+		}
+	}
+	return *key == '\0';
+}
@@ -0,0 +1,88 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserJson.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : On-demand JSON reader over the CParser buffer and cursor. No DOM and
+ *           no String allocations: memory is bounded by the nesting depth.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserJson_h_
+#define _CParserJson_h_
+
+#include "CParser.h"
+
+// Maximum nesting depth of objects and arrays that can be entered
+#ifndef CPARSER_JSON_DEPTH
+#define CPARSER_JSON_DEPTH 8
+#endif
+
+class CParserJson {
+public:
+	CParserJson(CParser &parser);
+
+	// Navigation methods
+	bool enterObject();
+	bool enterArray();
+	bool findKey(const char *key);
+	bool nextElement();
+	bool leave();
+	void skipValue();
+	uint8_t depth();
+
+	// Read methods, the cursor must be at the value
+	bool isNull();
+	bool readBool();
+	int32_t readInt32();
+	uint32_t readUnsignedInt32();
+	int32_t readDecimal(uint8_t scale);
+	float readFloat();
+	size_t readString(char *dst, size_t size);
+
+private:
+	CParser &m_parser;
+	size_t m_starts[CPARSER_JSON_DEPTH];
+	size_t m_value;
+	uint8_t m_depth;
+
+	// Structural index of the current 64 byte block
+	uint64_t m_mask;
+	size_t m_blockPos;
+	size_t m_blockEnd;
+	bool m_inString;
+	bool m_escaped;
+
+	bool enter(char open);
+	bool nextMember(const char *key, size_t stop);
+	void skipSpace();
+	void skipConsumed();
+	size_t scanNumber(size_t &first, size_t &point, size_t &end, int16_t &exponent);
+	size_t nextStructural(size_t from);
+	void classify(size_t from);
+	size_t closingQuote(size_t open);
+	uint32_t readHex(size_t &index, size_t end);
+	static uint8_t encodeUtf8(uint32_t codePoint, byte *dst);
+	bool keyEquals(size_t from, size_t to, const char *key);
+};
+
+#endif
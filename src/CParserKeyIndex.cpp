@@ -0,0 +1,175 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserKeyIndex.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : One pass key=value indexer for query strings and attribute lists.
+ *           Fixed capacity open addressing hash table, no heap.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserKeyIndex.h"
+
+CParserKeyIndex::CParserKeyIndex(CParserKeySlot *slots, uint8_t capacity, char pairSeparator, char keySeparator) {
+	m_parser = nullptr;
+	m_slots = slots;
+	m_capacity = capacity;
+	m_count = 0;
+	m_overflow = false;
+	m_pairSeparator = pairSeparator;
+	m_keySeparator = keySeparator;
+}
+
+// Indexes every key=value pair from the parser position to the end of its
+// buffer. The parser cursor is not moved. When a key appears more than once
+// the first occurrence wins and the others take no slot; pairs that do not fit
+// and keys longer than 255 bytes set the overflow flag.
+uint8_t CParserKeyIndex::build(CParser &parser) {
+	m_parser = &parser;
+	m_count = 0;
+	m_overflow = false;
+	for (uint8_t index = 0; index < m_capacity; index++) {
+		m_slots[index].keyLength = 0;
+	}
+
+	size_t pos = parser.m_pos;
+	size_t separator = parser.find(m_keySeparator, pos, parser.m_len);
+	while (pos < parser.m_len) {
+		size_t end = parser.find(m_pairSeparator, pos, parser.m_len);
+		if (separator < pos) {
+			separator = parser.find(m_keySeparator, pos, parser.m_len);
+		}
+		size_t keyEnd = separator < end ? separator : end;
+		size_t keyLength = keyEnd - pos;
+
+		if (keyLength > 0xFF) {
+			m_overflow = true;
+		} else if (keyLength > 0) {
+			uint16_t code = 5381;
+			for (size_t index = pos; index < keyEnd; index++) {
+				code = hash(code, parser.itemAt(index));
+			}
+
+			CParserKeySlot *slot = place(parser, code, pos, keyLength);
+			if (slot == nullptr) {
+				m_overflow = true;
+			} else if (slot->keyLength == 0) {
+				slot->key = pos;
+				slot->keyLength = keyLength;
+				slot->value = keyEnd < end ? keyEnd + 1 : end;
+				slot->valueLength = end - slot->value;
+				slot->tag = code >> 8;
+				m_count++;
+			}
+		}
+
+		pos = end + 1;
+	}
+
+	return m_count;
+}
+
+// Points value at the value of key, ready for the CParser read methods
+bool CParserKeyIndex::get(const char *key, CParser &value) {
+	CParserKeySlot *slot = lookup(key);
+	if (slot == nullptr) {
+		return false;
+	}
+	value.begin(*m_parser, slot->value, slot->valueLength);
+	return true;
+}
+
+bool CParserKeyIndex::contains(const char *key) {
+	return lookup(key) != nullptr;
+}
+
+uint8_t CParserKeyIndex::count() {
+	return m_count;
+}
+
+bool CParserKeyIndex::isOverflow() {
+	return m_overflow;
+}
+
+// Private methods
+CParserKeySlot *CParserKeyIndex::lookup(const char *key) {
+	if (m_parser == nullptr || m_capacity == 0) {
+		return nullptr;
+	}
+
+	uint16_t code = 5381;
+	size_t length = 0;
+	for (; key[length] != '\0'; length++) {
+		code = hash(code, key[length]);
+	}
+
+	uint8_t slot = code % m_capacity;
+	for (uint8_t probe = 0; probe < m_capacity; probe++) {
+		CParserKeySlot &entry = m_slots[slot];
+		if (entry.keyLength == 0) {
+			return nullptr;
+		}
+		if (entry.tag == (uint8_t)(code >> 8) && entry.keyLength == length) {
+			size_t index = 0;
+			while (index < length && m_parser->itemAt(entry.key + index) == (byte)key[index]) {
+				index++;
+			}
+			if (index == length) {
+				return &entry;
+			}
+		}
+		slot = (slot + 1 < m_capacity) ? slot + 1 : 0;
+	}
+	return nullptr;
+}
+
+// Slot already holding the key at key, or the free slot it goes to; nullptr
+// when the table is full and the key is not in it.
+CParserKeySlot *CParserKeyIndex::place(CParser &parser, uint16_t code, size_t key, uint8_t length) {
+	if (m_capacity == 0) {
+		return nullptr;
+	}
+
+	uint8_t slot = code % m_capacity;
+	for (uint8_t probe = 0; probe < m_capacity; probe++) {
+		CParserKeySlot &entry = m_slots[slot];
+		if (entry.keyLength == 0) {
+			return &entry;
+		}
+		if (entry.tag == (uint8_t)(code >> 8) && entry.keyLength == length) {
+			uint8_t index = 0;
+			while (index < length && parser.itemAt(entry.key + index) == parser.itemAt(key + index)) {
+				index++;
+			}
+			if (index == length) {
+				return &entry;
+			}
+		}
+		slot = (slot + 1 < m_capacity) ? slot + 1 : 0;
+	}
+	return nullptr;
+}
+
+// djb2, cheap on 8 bit cores: shifts and adds only
+uint16_t CParserKeyIndex::hash(uint16_t seed, byte item) {
+	return ((seed << 5) + seed) ^ item;
+}
@@ -0,0 +1,67 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserKeyIndex.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : One pass key=value indexer for query strings and attribute lists.
+ *           Fixed capacity open addressing hash table, no heap.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserKeyIndex_h_
+#define _CParserKeyIndex_h_
+
+#include "CParser.h"
+
+struct CParserKeySlot {
+	size_t key;
+	size_t value;
+	size_t valueLength;
+	uint8_t keyLength;
+	uint8_t tag;
+};
+
+class CParserKeyIndex {
+public:
+	CParserKeyIndex(CParserKeySlot *slots, uint8_t capacity, char pairSeparator = '&', char keySeparator = '=');
+
+	uint8_t build(CParser &parser);
+	bool get(const char *key, CParser &value);
+	bool contains(const char *key);
+	uint8_t count();
+	bool isOverflow();
+
+private:
+	CParser *m_parser;
+	CParserKeySlot *m_slots;
+	uint8_t m_capacity;
+	uint8_t m_count;
+	bool m_overflow;
+	char m_pairSeparator;
+	char m_keySeparator;
+
+	CParserKeySlot *lookup(const char *key);
+	CParserKeySlot *place(CParser &parser, uint16_t code, size_t key, uint8_t length);
+	static uint16_t hash(uint16_t seed, byte item);
+};
+
+#endif
@@ -0,0 +1,230 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserPattern.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Compiled patterns (regex-lite): linear chains of character classes
+ *           matched by a bit-parallel NFA, linear time and constant memory.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserPattern.h"
+
+// Shift-And simulation: bit i of the state is set when a path has matched the
+// positions 0 to i. start tells whether a match may begin at the current offset.
+uint32_t CParserPattern::close(uint32_t state, bool start) const {
+	uint32_t closed = state | (start ? m_optional & 1 : 0);
+	while (true) {
+		uint32_t next = closed | ((closed << 1) & m_optional);
+		if (next == closed) {
+			return closed;
+		}
+		closed = next;
+	}
+}
+
+bool CParserPattern::isAccepting(uint32_t state) const {
+	return m_positions == 0 || ((state >> (m_positions - 1)) & 1) != 0;
+}
+
+// Tracked simulation, one position at a time: every position keeps a value of
+// the best path reaching it, the earliest match start or the latest offset where
+// the path entered the position after boundary.
+uint32_t CParserPattern::stepTracked(uint32_t state, bool start, byte item, size_t offset, int8_t boundary, size_t *values, bool earliest) const {
+	uint32_t bits = mask(item);
+	uint32_t next = 0;
+
+	// descending, so values[position - 1] still belongs to the previous offset
+	for (int8_t position = m_positions - 1; position >= 0; position--) {
+		uint32_t bit = (uint32_t)1 << position;
+		if ((bits & bit) == 0) {
+			continue;
+		}
+
+		bool entered = position == 0 ? start : (state & (bit >> 1)) != 0;
+		bool stayed = (state & m_repeat & bit) != 0;
+		if (!entered && !stayed) {
+			continue;
+		}
+
+		size_t value = values[position];
+		if (entered) {
+			size_t from = (position == 0 || position - 1 == boundary) ? offset : values[position - 1];
+			if (!stayed || (earliest ? from < value : from > value)) {
+				value = from;
+			}
+		}
+		values[position] = value;
+		next |= bit;
+	}
+	return next;
+}
+
+uint32_t CParserPattern::closeTracked(uint32_t state, bool start, size_t offset, int8_t boundary, size_t *values, bool earliest) const {
+	for (int8_t position = 0; position < m_positions; position++) {
+		uint32_t bit = (uint32_t)1 << position;
+		bool entered = position == 0 ? start : (state & (bit >> 1)) != 0;
+		if ((m_optional & bit) == 0 || !entered) {
+			continue;
+		}
+
+		size_t from = (position == 0 || position - 1 == boundary) ? offset : values[position - 1];
+		if ((state & bit) == 0 || (earliest ? from < values[position] : from > values[position])) {
+			values[position] = from;
+		}
+		state |= bit;
+	}
+	return state;
+}
+
+// Leftmost-longest match starting at from (anchored) or after it
+bool CParserPattern::find(CParser &parser, size_t from, bool anchored, CParserSpan *span) const {
+	if (!m_valid) {
+		return false;
+	}
+
+	size_t to = parser.m_len;
+	if (from > to) {
+		from = to;
+	}
+
+	// Bit-parallel pass to the first offset where a match ends. No match starts
+	// before the last offset where every path had died.
+	size_t offset = from;
+	size_t dead = from;
+	bool start = true;
+	uint32_t state = close(0, start);
+	bool found = isAccepting(state);
+
+	while (!found && offset < to && (state != 0 || start)) {
+		size_t avail;
+		byte *items = parser.spanAt(offset, avail);
+		if (avail > to - offset) {
+			avail = to - offset;
+		}
+
+		size_t index = 0;
+		while (index < avail && !found && (state != 0 || start)) {
+			uint32_t bits = mask(items[index++]);
+			state = (((state << 1) | (start ? 1 : 0)) & bits) | (state & m_repeat & bits);
+			if (state == 0) {
+				dead = offset + index;
+			}
+			start = !anchored;
+			state = close(state, start);
+			found = isAccepting(state);
+		}
+		offset += index;
+	}
+
+	if (!found) {
+		return false;
+	}
+	if (span == nullptr) {
+		return true;
+	}
+
+	// Tracked pass from there: the earliest start wins, then the latest end of it
+	size_t values[CPARSER_PATTERN_POSITIONS] = {};
+	size_t first = 0;
+	size_t last = 0;
+	bool matched = false;
+
+	offset = anchored ? from : dead;
+	state = closeTracked(0, true, offset, -1, values, true);
+	while (true) {
+		if (isAccepting(state)) {
+			size_t begin = m_positions > 0 ? values[m_positions - 1] : offset;
+			if (!matched || begin < first) {
+				first = begin;
+				last = offset;
+				matched = true;
+			} else if (begin == first) {
+				last = offset;
+			}
+		}
+		if (offset >= to) {
+			break;
+		}
+
+		bool live = false;
+		for (uint8_t position = 0; position < m_positions; position++) {
+			if (((state >> position) & 1) != 0 && (!matched || values[position] <= first)) {
+				live = true;
+			}
+		}
+		bool inject = !anchored && !matched;
+		start = inject || offset == (anchored ? from : dead);
+		if (!live && !start) {
+			break;
+		}
+
+		state = stepTracked(state, start, parser.itemAt(offset), offset, -1, values, true);
+		offset++;
+		state = closeTracked(state, inject, offset, -1, values, true);
+	}
+
+	span->start = first;
+	span->length = last - first;
+	return true;
+}
+
+// Group boundaries of a match, one tracked pass each. Taking the latest crossing
+// of every boundary in turn makes captures greedy from left to right.
+void CParserPattern::capture(CParser &parser, CParserMatch &match) const {
+	size_t from = match.span.start;
+	size_t to = from + match.span.length;
+	int8_t after = -1;
+
+	match.groupCount = m_groups;
+	for (uint8_t group = 0; group < m_groups; group++) {
+		int8_t first = (int8_t)m_groupFirst[group] - 1;
+		from = boundary(parser, from, after, first, to);
+		after = first;
+		match.groups[group].start = from;
+
+		int8_t last = (int8_t)m_groupLast[group];
+		from = boundary(parser, from, after, last, to);
+		after = last;
+		match.groups[group].length = from - match.groups[group].start;
+	}
+}
+
+// Latest offset in [from, to] where a path that is past position after at from
+// and matches up to to crosses from position boundary to the next one
+size_t CParserPattern::boundary(CParser &parser, size_t from, int8_t after, int8_t boundary, size_t to) const {
+	if (boundary == after) {
+		return from;
+	}
+	if (boundary == m_positions - 1) {
+		return to;
+	}
+
+	size_t values[CPARSER_PATTERN_POSITIONS] = {};
+	bool start = after < 0;
+	uint32_t state = closeTracked(start ? 0 : (uint32_t)1 << after, start, from, boundary, values, false);
+	for (size_t offset = from; offset < to; offset++) {
+		state = stepTracked(state, start && offset == from, parser.itemAt(offset), offset, boundary, values, false);
+		state = closeTracked(state, false, offset + 1, boundary, values, false);
+	}
+	return values[m_positions - 1];
+}
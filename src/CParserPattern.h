@@ -0,0 +1,282 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserPattern.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Compiled patterns (regex-lite): linear chains of character classes
+ *           matched by a bit-parallel NFA, linear time and constant memory.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserPattern_h_
+#define _CParserPattern_h_
+
+#include "CParser.h"
+
+// Positions are the bits of the NFA state word
+#define CPARSER_PATTERN_POSITIONS 32
+// Byte classes are stored as nibbles
+#define CPARSER_PATTERN_CLASSES 16
+
+#ifndef CPARSER_PATTERN_GROUPS
+#define CPARSER_PATTERN_GROUPS 4
+#endif
+
+// Logical offset and length of a match in the parser buffer, to be read back
+// with begin(parser, start, length)
+struct CParserSpan {
+	size_t start;
+	size_t length;
+};
+
+struct CParserMatch {
+	CParserSpan span;
+	CParserSpan groups[CPARSER_PATTERN_GROUPS];
+	uint8_t groupCount;
+};
+
+// Pattern syntax, a concatenation of atoms with optional quantifiers:
+//   c          literal byte, \c escapes any special byte
+//   .          any byte
+//   \d \w \s \x  digit, word (alfanumeric or _), blank, hex digit; \D \W \S \X negated
+//   \n \r \t   control bytes
+//   [a-z_\d]   class of ranges, bytes and escapes; [^...] negated
+//   ? * + {n} {n,} {n,m}  quantifiers, m up to 255
+//   (...)      capture group, not nested and without quantifier
+// Each quantified atom expands to as many NFA positions as it needs (a{2,4} takes
+// four, a+ and a* one), up to 32 in total, and the atoms may use at most 15
+// distinct byte classes. Matches are leftmost-longest, and captures are greedy
+// from left to right. The constructor is constexpr from C++14, so a constexpr
+// pattern is compiled by the compiler and kept in read-only memory.
+class CParserPattern {
+public:
+	CPARSER_CONSTEXPR CParserPattern(const char *pattern)
+		: m_classOf(), m_masks(), m_repeat(0), m_optional(0), m_positions(0), m_classes(1), m_groups(0), m_groupFirst(), m_groupLast(), m_valid(true) {
+		const char *atoms[CPARSER_PATTERN_POSITIONS] = {};
+		bool inGroup = false;
+
+		while (m_valid && *pattern != '\0') {
+			if (*pattern == '(' || *pattern == ')') {
+				bool open = *pattern == '(';
+				if (open == inGroup || (open && m_groups == CPARSER_PATTERN_GROUPS) || (!open && m_groupFirst[m_groups] == m_positions)) {
+					m_valid = false;
+				} else if (open) {
+					m_groupFirst[m_groups] = m_positions;
+				} else {
+					m_groupLast[m_groups++] = m_positions - 1;
+				}
+				inGroup = open;
+				pattern++;
+				continue;
+			}
+
+			const char *atom = pattern;
+			pattern = skipAtom(atom);
+			if (pattern == nullptr) {
+				m_valid = false;
+				break;
+			}
+
+			uint16_t min = 1;
+			uint16_t max = 1;
+			if (*pattern == '?' || *pattern == '*' || *pattern == '+') {
+				min = *pattern == '+' ? 1 : 0;
+				max = *pattern == '?' ? 1 : 256;
+				pattern++;
+			} else if (*pattern == '{') {
+				pattern = readNumber(pattern + 1, min);
+				max = min;
+				if (*pattern == ',') {
+					max = 256;
+					if (pattern[1] != '}') {
+						pattern = readNumber(pattern + 1, max);
+					} else {
+						pattern++;
+					}
+				}
+				if (*pattern != '}' || max < min || max == 0 || (max > 255 && max != 256)) {
+					m_valid = false;
+					break;
+				}
+				pattern++;
+			}
+
+			// An unbounded atom ends with a repeatable position
+			uint16_t count = max == 256 ? (min > 0 ? min : 1) : max;
+			if (count > CPARSER_PATTERN_POSITIONS - m_positions) {
+				m_valid = false;
+				break;
+			}
+			for (uint16_t index = 0; index < count; index++) {
+				uint32_t bit = (uint32_t)1 << m_positions;
+				if (index >= min) {
+					m_optional |= bit;
+				}
+				if (max == 256 && index == count - 1) {
+					m_repeat |= bit;
+				}
+				atoms[m_positions++] = atom;
+			}
+		}
+
+		if (inGroup) {
+			m_valid = false;
+		}
+
+		// Bytes with the same set of positions share one class, class 0 matches none
+		for (uint16_t item = 0; m_valid && item < 256; item++) {
+			uint32_t mask = 0;
+			for (uint8_t position = 0; position < m_positions; position++) {
+				if (contains(atoms[position], (byte)item)) {
+					mask |= (uint32_t)1 << position;
+				}
+			}
+
+			uint8_t index = 0;
+			while (index < m_classes && m_masks[index] != mask) {
+				index++;
+			}
+			if (index == m_classes) {
+				if (m_classes == CPARSER_PATTERN_CLASSES) {
+					m_valid = false;
+					break;
+				}
+				m_masks[m_classes++] = mask;
+			}
+			m_classOf[item >> 1] |= (byte)(index << ((item & 1) << 2));
+		}
+	}
+
+	constexpr bool isValid() const {
+		return m_valid;
+	}
+
+	constexpr uint8_t positions() const {
+		return m_positions;
+	}
+
+	constexpr uint8_t groups() const {
+		return m_groups;
+	}
+
+private:
+	byte m_classOf[128];
+	uint32_t m_masks[CPARSER_PATTERN_CLASSES];
+	uint32_t m_repeat;
+	uint32_t m_optional;
+	uint8_t m_positions;
+	uint8_t m_classes;
+	uint8_t m_groups;
+	uint8_t m_groupFirst[CPARSER_PATTERN_GROUPS];
+	uint8_t m_groupLast[CPARSER_PATTERN_GROUPS];
+	bool m_valid;
+
+	constexpr uint32_t mask(byte item) const {
+		return m_masks[(m_classOf[item >> 1] >> ((item & 1) << 2)) & 0x0F];
+	}
+
+	static CPARSER_CONSTEXPR const char *skipAtom(const char *atom) {
+		switch (*atom) {
+		case '\\':
+			return atom[1] != '\0' ? atom + 2 : nullptr;
+		case '[':
+			atom += atom[1] == '^' ? 2 : 1;
+			if (*atom == ']') {
+				return nullptr;
+			}
+			while (*atom != ']') {
+				if (*atom == '\0' || (*atom == '\\' && atom[1] == '\0')) {
+					return nullptr;
+				}
+				atom += *atom == '\\' ? 2 : 1;
+			}
+			return atom + 1;
+		case '?': case '*': case '+': case '{': case '\0':
+			return nullptr;
+		default:
+			return atom + 1;
+		}
+	}
+
+	static CPARSER_CONSTEXPR const char *readNumber(const char *str, uint16_t &value) {
+		value = 0;
+		while (*str >= '0' && *str <= '9' && value < 256) {
+			value = value * 10 + (*str++ - '0');
+		}
+		return str;
+	}
+
+	static CPARSER_CONSTEXPR bool escapeContains(char escape, byte item) {
+		switch (escape) {
+		case 'd': return item >= '0' && item <= '9';
+		case 'w': return CParser::isAlfaNumeric(item) || item == '_';
+		case 's': return item == ' ' || item == '\t' || item == '\r' || item == '\n';
+		case 'x': return CParser::isDigit(item) || (item >= 'A' && item <= 'F') || (item >= 'a' && item <= 'f');
+		case 'D': case 'W': case 'S': case 'X': return !escapeContains(escape + ('a' - 'A'), item);
+		case 'n': return item == '\n';
+		case 'r': return item == '\r';
+		case 't': return item == '\t';
+		default: return item == (byte)escape;
+		}
+	}
+
+	static CPARSER_CONSTEXPR bool contains(const char *atom, byte item) {
+		if (*atom == '.') {
+			return true;
+		}
+		if (*atom == '\\') {
+			return escapeContains(atom[1], item);
+		}
+		if (*atom != '[') {
+			return item == (byte)*atom;
+		}
+
+		bool negate = atom[1] == '^';
+		bool found = false;
+		atom += negate ? 2 : 1;
+		while (*atom != ']') {
+			if (*atom == '\\') {
+				found = found || escapeContains(atom[1], item);
+				atom += 2;
+			} else if (atom[1] == '-' && atom[2] != ']' && atom[2] != '\0') {
+				found = found || (item >= (byte)atom[0] && item <= (byte)atom[2]);
+				atom += 3;
+			} else {
+				found = found || item == (byte)*atom;
+				atom++;
+			}
+		}
+		return found != negate;
+	}
+
+	uint32_t close(uint32_t state, bool start) const;
+	uint32_t closeTracked(uint32_t state, bool start, size_t offset, int8_t boundary, size_t *values, bool earliest) const;
+	uint32_t stepTracked(uint32_t state, bool start, byte item, size_t offset, int8_t boundary, size_t *values, bool earliest) const;
+	bool isAccepting(uint32_t state) const;
+	bool find(CParser &parser, size_t from, bool anchored, CParserSpan *span) const;
+	void capture(CParser &parser, CParserMatch &match) const;
+	size_t boundary(CParser &parser, size_t from, int8_t after, int8_t boundary, size_t to) const;
+
+	friend class CParser;
+};
+
+#endif
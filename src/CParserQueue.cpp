@@ -0,0 +1,167 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserQueue.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Lock-free single producer / single consumer byte queue. An interrupt
+ *           handler pushes bytes, loop() parses complete frames in place.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserQueue.h"
+
+// Each index has a single writer: the producer owns m_head, m_frameStart,
+// m_framesIn and m_dropped, the consumer owns m_tail and m_framesOut. Publishing with release
+// and reading the other side with acquire is all the synchronization needed.
+#define CPARSER_LOAD(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define CPARSER_STORE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+CParserQueue::CParserQueue(byte *storage, size_t capacity) {
+	init(storage, capacity);
+	m_framed = false;
+	m_delimiter = 0;
+}
+
+CParserQueue::CParserQueue(byte *storage, size_t capacity, char delimiter) {
+	init(storage, capacity);
+	m_framed = true;
+	m_delimiter = delimiter;
+}
+
+void CParserQueue::init(byte *storage, size_t capacity) {
+	// Round capacity down to a power of two the index type can address. One
+	// slot is kept free, so below 2 the queue is rejected: every push fails.
+	if (capacity < 2) {
+		capacity = 1;
+	}
+	if (capacity > (size_t)(CParserQueueIndex)-1) {
+		capacity = (size_t)(CParserQueueIndex)-1 + 1;
+	}
+	while (capacity & (capacity - 1)) {
+		capacity &= capacity - 1;
+	}
+
+	m_buf = storage;
+	m_capacity = capacity;
+	m_mask = capacity - 1;
+	m_head = 0;
+	m_tail = 0;
+	m_frameStart = 0;
+	m_discarding = false;
+	m_framesIn = 0;
+	m_framesOut = 0;
+	m_dropped = 0;
+}
+
+// Producer methods
+// In a framed queue only complete frames reach the consumer: once a byte of a
+// frame is lost, or no frame end slot is free, the whole frame is discarded up
+// to and including its delimiter.
+bool CParserQueue::push(byte item) {
+	if (m_mask == 0) {
+		CPARSER_STORE(m_dropped, (uint8_t)(m_dropped + 1));
+		return false;
+	}
+
+	CParserQueueIndex head = m_head;
+	uint8_t in = m_framesIn;
+	bool isEndFree = (uint8_t)(in - CPARSER_LOAD(m_framesOut)) < CPARSER_QUEUE_FRAMES;
+
+	if (m_framed && item == m_delimiter) {
+		if (m_discarding || !isEndFree) {
+			m_discarding = false;
+			return discard(head);
+		}
+		m_ends[in & (CPARSER_QUEUE_FRAMES - 1)] = head;
+		m_frameStart = head;
+		CPARSER_STORE(m_framesIn, (uint8_t)(in + 1));
+		return true;
+	}
+
+	// One slot is kept free so that a full ring never looks empty
+	bool isFull = (CParserQueueIndex)(head - CPARSER_LOAD(m_tail)) >= m_mask;
+	if (m_framed && (m_discarding || isFull || !isEndFree)) {
+		m_discarding = true;
+		return discard(head);
+	}
+	if (isFull) {
+		CPARSER_STORE(m_dropped, (uint8_t)(m_dropped + 1));
+		return false;
+	}
+	m_buf[head & m_mask] = item;
+	CPARSER_STORE(m_head, (CParserQueueIndex)(head + 1));
+	return true;
+}
+
+// Drops the byte and the partial frame before it, giving back its ring space
+bool CParserQueue::discard(CParserQueueIndex head) {
+	CParserQueueIndex lost = head - m_frameStart;
+	CPARSER_STORE(m_head, m_frameStart);
+	CPARSER_STORE(m_dropped, (uint8_t)(m_dropped + lost + 1));
+	return false;
+}
+
+// Consumer methods
+size_t CParserQueue::available() {
+	return (CParserQueueIndex)(CPARSER_LOAD(m_head) - m_tail);
+}
+
+size_t CParserQueue::frames() {
+	return (uint8_t)(CPARSER_LOAD(m_framesIn) - m_framesOut);
+}
+
+// Bytes dropped so far, delimiters included, modulo 256
+size_t CParserQueue::dropped() {
+	return CPARSER_LOAD(m_dropped);
+}
+
+// Byte by byte consumer, for queues built without a frame delimiter
+bool CParserQueue::pop(byte &item) {
+	CParserQueueIndex tail = m_tail;
+	if (tail == CPARSER_LOAD(m_head)) {
+		return false;
+	}
+	item = m_buf[tail & m_mask];
+	CPARSER_STORE(m_tail, (CParserQueueIndex)(tail + 1));
+	return true;
+}
+
+// Points the parser at the oldest complete frame, read in place from the ring.
+// The bytes stay reserved until endFrame() releases them to the producer.
+bool CParserQueue::beginFrame(CParser &parser) {
+	uint8_t out = m_framesOut;
+	if (out == CPARSER_LOAD(m_framesIn)) {
+		return false;
+	}
+	CParserQueueIndex end = m_ends[out & (CPARSER_QUEUE_FRAMES - 1)];
+	parser.begin(m_buf, m_capacity, m_tail & m_mask, end & m_mask);
+	return true;
+}
+
+void CParserQueue::endFrame() {
+	uint8_t out = m_framesOut;
+	if (out == CPARSER_LOAD(m_framesIn)) {
+		return;
+	}
+	CPARSER_STORE(m_tail, m_ends[out & (CPARSER_QUEUE_FRAMES - 1)]);
+	CPARSER_STORE(m_framesOut, (uint8_t)(out + 1));
+}
@@ -0,0 +1,84 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserQueue.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Lock-free single producer / single consumer byte queue. An interrupt
+ *           handler pushes bytes, loop() parses complete frames in place.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserQueue_h_
+#define _CParserQueue_h_
+
+#include "CParser.h"
+
+// Maximum number of complete frames waiting for the consumer (power of two)
+#ifndef CPARSER_QUEUE_FRAMES
+#define CPARSER_QUEUE_FRAMES 8
+#endif
+
+// Indexes must be loaded and stored in a single instruction by both sides
+#if defined(__AVR__)
+typedef uint8_t CParserQueueIndex;
+#else
+typedef size_t CParserQueueIndex;
+#endif
+
+// Capacity is rounded down to a power of two, of which one byte stays unused;
+// queues smaller than 2 bytes reject every push.
+class CParserQueue {
+public:
+	CParserQueue(byte *storage, size_t capacity);
+	CParserQueue(byte *storage, size_t capacity, char delimiter);
+
+	// Producer methods (interrupt context)
+	bool push(byte item);
+
+	// Consumer methods
+	size_t available();
+	size_t frames();
+	size_t dropped();
+	bool pop(byte &item);
+	bool beginFrame(CParser &parser);
+	void endFrame();
+
+private:
+	byte *m_buf;
+	size_t m_capacity;
+	CParserQueueIndex m_mask;
+	CParserQueueIndex m_head;
+	CParserQueueIndex m_tail;
+	CParserQueueIndex m_frameStart;
+	CParserQueueIndex m_ends[CPARSER_QUEUE_FRAMES];
+	uint8_t m_framesIn;
+	uint8_t m_framesOut;
+	uint8_t m_dropped;
+	bool m_framed;
+	bool m_discarding;
+	byte m_delimiter;
+
+	void init(byte *storage, size_t capacity);
+	bool discard(CParserQueueIndex head);
+};
+
+#endif
@@ -0,0 +1,125 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserTokenCache.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Token boundary cache: offsets of one separator or criterion recorded
+ *           on the first pass, served to later passes over the same buffer.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserTokenCache.h"
+
+CParserTokenCache::CParserTokenCache(size_t *offsets, size_t capacity) {
+	m_offsets = offsets;
+	m_capacity = capacity;
+	m_criterion = nullptr;
+	m_item = 0;
+	m_key = KEY_NONE;
+	invalidate(0);
+}
+
+// Drops the recorded offsets
+void CParserTokenCache::clear() {
+	invalidate(m_length);
+}
+
+size_t CParserTokenCache::count() {
+	return m_count;
+}
+
+// True when the whole buffer has been recorded
+bool CParserTokenCache::isComplete() {
+	return m_covered >= m_length;
+}
+
+bool CParserTokenCache::isOverflow() {
+	return m_count >= m_capacity && !isComplete();
+}
+
+void CParserTokenCache::bind(byte item) {
+	m_key = KEY_ITEM;
+	m_item = item;
+}
+
+void CParserTokenCache::bind(CParserCriterion criterion) {
+	m_key = KEY_CRITERION;
+	m_criterion = criterion;
+}
+
+bool CParserTokenCache::isBoundTo(byte item) {
+	return m_key == KEY_ITEM && m_item == item;
+}
+
+bool CParserTokenCache::isBoundTo(CParserCriterion criterion) {
+	return m_key == KEY_CRITERION && m_criterion == criterion;
+}
+
+// Answers a scan of [from, to) from the covered range: returns true with from
+// set to the first match (or to), otherwise moves from to where scanning must go on.
+bool CParserTokenCache::lookup(size_t &from, size_t to) {
+	if (from >= m_covered) {
+		return false;
+	}
+
+	size_t low = 0;
+	size_t high = m_count;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (m_offsets[middle] < from) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	if (low < m_count) {
+		from = m_offsets[low] < to ? m_offsets[low] : to;
+		return true;
+	}
+	if (m_covered >= to) {
+		from = to;
+		return true;
+	}
+	from = m_covered;
+	return false;
+}
+
+// Records the result of a scan of [from, to) that found index; only scans
+// continuing the covered range can be recorded.
+void CParserTokenCache::record(size_t from, size_t index, size_t to) {
+	if (from != m_covered) {
+		return;
+	}
+	if (index >= to) {
+		m_covered = to;
+	} else if (m_count < m_capacity) {
+		m_offsets[m_count++] = index;
+		m_covered = index + 1;
+	}
+}
+
+void CParserTokenCache::invalidate(size_t length) {
+	m_count = 0;
+	m_covered = 0;
+	m_length = length;
+}
@@ -0,0 +1,76 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserTokenCache.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Token boundary cache: offsets of one separator or criterion recorded
+ *           on the first pass, served to later passes over the same buffer.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserTokenCache_h_
+#define _CParserTokenCache_h_
+
+#include "CParser.h"
+
+// Sorted offsets of the items matching one separator or criterion, in caller
+// storage. The separator or criterion is given to CParser::attachCache(); the
+// cache records its matches while a pass walks the buffer and answers scans of
+// the range already covered by binary search. When the storage is full the rest
+// of the buffer is scanned as usual.
+class CParserTokenCache {
+public:
+	CParserTokenCache(size_t *offsets, size_t capacity);
+
+	void clear();
+	size_t count();
+	bool isComplete();
+	bool isOverflow();
+
+private:
+	enum Key {
+		KEY_NONE,
+		KEY_ITEM,
+		KEY_CRITERION
+	};
+
+	size_t *m_offsets;
+	size_t m_capacity;
+	size_t m_count;
+	size_t m_covered;
+	size_t m_length;
+	CParserCriterion m_criterion;
+	byte m_item;
+	Key m_key;
+
+	void bind(byte item);
+	void bind(CParserCriterion criterion);
+	bool isBoundTo(byte item);
+	bool isBoundTo(CParserCriterion criterion);
+	bool lookup(size_t &from, size_t to);
+	void record(size_t from, size_t index, size_t to);
+	void invalidate(size_t length);
+
+	friend class CParser;
+};
+
+#endif
@@ -0,0 +1,316 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserUtf8.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : UTF-8 validation and code point helpers. Lookup table validation on
+ *           SSSE3 and AArch64 NEON, word at a time ASCII fast path elsewhere.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CParserUtf8.h"
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#define CPARSER_UTF8_SIMD
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CPARSER_UTF8_SIMD
+#endif
+
+// Every byte of a machine word with only its top bit set
+#define CPARSER_WORD_HIGH_BITS ((size_t)-1 / 0xFF * 0x80)
+
+#ifdef CPARSER_UTF8_SIMD
+// Keiser and Lemire validation: the high and low nibble of each byte and the
+// high nibble of the next one select error classes from three tables, any
+// class set in all three is an error. Continuations due to a three or four
+// byte lead are checked separately.
+#define TOO_SHORT      (1 << 0)
+#define TOO_LONG       (1 << 1)
+#define OVERLONG_3     (1 << 2)
+#define TOO_LARGE      (1 << 3)
+#define SURROGATE      (1 << 4)
+#define OVERLONG_2     (1 << 5)
+#define TOO_LARGE_1000 (1 << 6)
+#define OVERLONG_4     (1 << 6)
+#define TWO_CONTS      (1 << 7)
+#define CARRY          (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+static const byte firstHigh[16] = {
+	TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+	TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+	TOO_SHORT | OVERLONG_2,
+	TOO_SHORT,
+	TOO_SHORT | OVERLONG_3 | SURROGATE,
+	TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+static const byte firstLow[16] = {
+	CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+	CARRY | OVERLONG_2,
+	CARRY,
+	CARRY,
+	CARRY | TOO_LARGE,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+	CARRY | TOO_LARGE | TOO_LARGE_1000,
+	CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+static const byte secondHigh[16] = {
+	TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+	TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+	TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+// A lead byte this close to the end of a block needs the next block
+static const byte incompleteMax[16] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+#endif
+
+bool CParserUtf8::validate(const byte *buf, size_t len) {
+#if defined(__SSSE3__)
+	const __m128i tableFirstHigh = _mm_loadu_si128((const __m128i *)firstHigh);
+	const __m128i tableFirstLow = _mm_loadu_si128((const __m128i *)firstLow);
+	const __m128i tableSecondHigh = _mm_loadu_si128((const __m128i *)secondHigh);
+	const __m128i maxValue = _mm_loadu_si128((const __m128i *)incompleteMax);
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	__m128i previous = _mm_setzero_si128();
+	__m128i incomplete = _mm_setzero_si128();
+	__m128i error = _mm_setzero_si128();
+	byte tail[16];
+
+	for (size_t index = 0; index < len; index += 16) {
+		__m128i input;
+		if (index + 16 <= len) {
+			input = _mm_loadu_si128((const __m128i *)(buf + index));
+		} else {
+			memset(tail, 0, sizeof(tail));
+			memcpy(tail, buf + index, len - index);
+			input = _mm_loadu_si128((const __m128i *)tail);
+		}
+
+		if (_mm_movemask_epi8(input) == 0) {
+			error = _mm_or_si128(error, incomplete);
+			incomplete = _mm_setzero_si128();
+		} else {
+			__m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+			__m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+			__m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+			__m128i special = _mm_and_si128(
+				_mm_and_si128(
+					_mm_shuffle_epi8(tableFirstHigh, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+					_mm_shuffle_epi8(tableFirstLow, _mm_and_si128(prev1, nibble))),
+				_mm_shuffle_epi8(tableSecondHigh, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+			__m128i continuation = _mm_and_si128(
+				_mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)), _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80))),
+				_mm_set1_epi8((char)0x80));
+			error = _mm_or_si128(error, _mm_xor_si128(continuation, special));
+			incomplete = _mm_subs_epu8(input, maxValue);
+		}
+		previous = input;
+	}
+
+	error = _mm_or_si128(error, incomplete);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+#elif defined(CPARSER_UTF8_SIMD)
+	const uint8x16_t tableFirstHigh = vld1q_u8(firstHigh);
+	const uint8x16_t tableFirstLow = vld1q_u8(firstLow);
+	const uint8x16_t tableSecondHigh = vld1q_u8(secondHigh);
+	const uint8x16_t maxValue = vld1q_u8(incompleteMax);
+	const uint8x16_t nibble = vdupq_n_u8(0x0F);
+	uint8x16_t previous = vdupq_n_u8(0);
+	uint8x16_t incomplete = vdupq_n_u8(0);
+	uint8x16_t error = vdupq_n_u8(0);
+	byte tail[16];
+
+	for (size_t index = 0; index < len; index += 16) {
+		uint8x16_t input;
+		if (index + 16 <= len) {
+			input = vld1q_u8(buf + index);
+		} else {
+			memset(tail, 0, sizeof(tail));
+			memcpy(tail, buf + index, len - index);
+			input = vld1q_u8(tail);
+		}
+
+		if (vmaxvq_u8(input) < 0x80) {
+			error = vorrq_u8(error, incomplete);
+			incomplete = vdupq_n_u8(0);
+		} else {
+			uint8x16_t prev1 = vextq_u8(previous, input, 15);
+			uint8x16_t prev2 = vextq_u8(previous, input, 14);
+			uint8x16_t prev3 = vextq_u8(previous, input, 13);
+			uint8x16_t special = vandq_u8(
+				vandq_u8(vqtbl1q_u8(tableFirstHigh, vshrq_n_u8(prev1, 4)), vqtbl1q_u8(tableFirstLow, vandq_u8(prev1, nibble))),
+				vqtbl1q_u8(tableSecondHigh, vshrq_n_u8(input, 4)));
+			uint8x16_t continuation = vandq_u8(
+				vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)), vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80))),
+				vdupq_n_u8(0x80));
+			error = vorrq_u8(error, veorq_u8(continuation, special));
+			incomplete = vqsubq_u8(input, maxValue);
+		}
+		previous = input;
+	}
+
+	error = vorrq_u8(error, incomplete);
+	return vmaxvq_u8(error) == 0;
+#else
+	return validateScalar(buf, len);
+#endif
+}
+
+// Number of code points, counting every byte that is not a continuation
+size_t CParserUtf8::count(const byte *buf, size_t len) {
+	size_t continuations = 0;
+	size_t index = 0;
+
+	for (; index + sizeof(size_t) <= len; index += sizeof(size_t)) {
+		size_t word;
+		memcpy(&word, buf + index, sizeof(word));
+		size_t marks = (word & ~(word << 1) & CPARSER_WORD_HIGH_BITS) >> 7;
+		continuations += (marks * ((size_t)-1 / 0xFF)) >> ((sizeof(size_t) - 1) * 8);
+	}
+	for (; index < len; index++) {
+		continuations += (buf[index] & 0xC0) == 0x80;
+	}
+
+	return len - continuations;
+}
+
+// Decodes one code point, CPARSER_UTF8_INVALID with length 1 if malformed
+uint32_t CParserUtf8::decode(const byte *buf, size_t len, size_t &length) {
+	length = 1;
+	if (len == 0) {
+		return CPARSER_UTF8_INVALID;
+	}
+
+	byte lead = buf[0];
+	if (lead < 0x80) {
+		return lead;
+	}
+
+	uint8_t count;
+	uint32_t codePoint;
+	uint32_t minimum;
+	if ((lead & 0xE0) == 0xC0) {
+		count = 2;
+		codePoint = lead & 0x1F;
+		minimum = 0x80;
+	} else if ((lead & 0xF0) == 0xE0) {
+		count = 3;
+		codePoint = lead & 0x0F;
+		minimum = 0x800;
+	} else if ((lead & 0xF8) == 0xF0) {
+		count = 4;
+		codePoint = lead & 0x07;
+		minimum = 0x10000;
+	} else {
+		return CPARSER_UTF8_INVALID;
+	}
+
+	if (count > len) {
+		return CPARSER_UTF8_INVALID;
+	}
+	for (uint8_t index = 1; index < count; index++) {
+		if ((buf[index] & 0xC0) != 0x80) {
+			return CPARSER_UTF8_INVALID;
+		}
+		codePoint = (codePoint << 6) | (buf[index] & 0x3F);
+	}
+	if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+		return CPARSER_UTF8_INVALID;
+	}
+
+	length = count;
+	return codePoint;
+}
+
+// Length of buf without a trailing sequence whose lead announces more bytes
+// than are left, so that it can be completed from the next span
+size_t CParserUtf8::complete(const byte *buf, size_t len) {
+	for (size_t back = 1; back <= 3 && back <= len; back++) {
+		byte item = buf[len - back];
+		if ((item & 0xC0) == 0x80) {
+			continue;
+		}
+		if (item >= 0xC0) {
+			size_t needed = (item >= 0xF0) ? 4 : (item >= 0xE0) ? 3 : 2;
+			if (needed > back) {
+				return len - back;
+			}
+		}
+		break;
+	}
+	return len;
+}
+
+// Largest prefix of a length byte view not longer than maxLength that does
+// not cut a code point in two
+size_t CParserUtf8::truncate(const char *str, size_t length, size_t maxLength) {
+	if (length <= maxLength) {
+		return length;
+	}
+	while (maxLength > 0 && (str[maxLength] & 0xC0) == 0x80) {
+		maxLength--;
+	}
+	return maxLength;
+}
+
+// Private methods
+bool CParserUtf8::validateScalar(const byte *buf, size_t len) {
+	size_t index = 0;
+
+	while (index < len) {
+		for (; index + sizeof(size_t) <= len; index += sizeof(size_t)) {
+			size_t word;
+			memcpy(&word, buf + index, sizeof(word));
+			if (word & CPARSER_WORD_HIGH_BITS) {
+				break;
+			}
+		}
+		if (index >= len) {
+			break;
+		}
+
+		size_t length;
+		if (decode(buf + index, len - index, length) == CPARSER_UTF8_INVALID) {
+			return false;
+		}
+		index += length;
+	}
+
+	return true;
+}
@@ -0,0 +1,50 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserUtf8.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : UTF-8 validation and code point helpers. Lookup table validation on
+ *           SSSE3 and AArch64 NEON, word at a time ASCII fast path elsewhere.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserUtf8_h_
+#define _CParserUtf8_h_
+
+#include "CParser.h"
+
+#define CPARSER_UTF8_INVALID 0xFFFFFFFFUL
+#define CPARSER_UTF8_REPLACEMENT 0xFFFDUL
+
+class CParserUtf8 {
+public:
+	static bool validate(const byte *buf, size_t len);
+	static size_t count(const byte *buf, size_t len);
+	static uint32_t decode(const byte *buf, size_t len, size_t &length);
+	static size_t complete(const byte *buf, size_t len);
+	static size_t truncate(const char *str, size_t length, size_t maxLength);
+
+private:
+	static bool validateScalar(const byte *buf, size_t len);
+};
+
+#endif
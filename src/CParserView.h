@@ -0,0 +1,264 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CParserView.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Read-only cursor over constant text. With C++14 or later every method
+ *           is constexpr, so static configuration strings are parsed at compile time.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CParserView_h_
+#define _CParserView_h_
+
+#include "CParser.h"
+
+// Same cursor semantics as CParser, over const text and without callbacks.
+// Additions: expect() moves past a token or sets an error flag, which failed
+// integer reads also set.
+class CParserView {
+public:
+	constexpr CParserView() : m_buf(nullptr), m_pos(0), m_len(0), m_error(false) { }
+	constexpr CParserView(const char *str) : m_buf(str), m_pos(0), m_len(length(str)), m_error(false) { }
+	constexpr CParserView(const char *buf, size_t len) : m_buf(buf), m_pos(0), m_len(len), m_error(false) { }
+
+	CPARSER_CONSTEXPR void begin(const char *str) {
+		begin(str, length(str));
+	}
+
+	CPARSER_CONSTEXPR void begin(const char *buf, size_t len) {
+		m_buf = buf;
+		m_len = len;
+		m_pos = 0;
+		m_error = false;
+	}
+
+	constexpr char currentItem() const {
+		return isBufferOverflow() ? '\0' : m_buf[m_pos];
+	}
+
+	constexpr size_t position() const {
+		return m_pos;
+	}
+
+	constexpr bool isBufferOverflow() const {
+		return m_pos >= m_len;
+	}
+
+	// Set by reads and expectations that did not find what they wanted
+	constexpr bool isError() const {
+		return m_error;
+	}
+
+	CPARSER_CONSTEXPR void reset() {
+		m_pos = 0;
+		m_error = false;
+	}
+
+	// Read methods
+	CPARSER_CONSTEXPR char readChar() {
+		char rst = currentItem();
+		next();
+		return rst;
+	}
+
+	CPARSER_CONSTEXPR int8_t readInt8() {
+		return readInteger<int8_t>();
+	}
+
+	CPARSER_CONSTEXPR int16_t readInt16() {
+		return readInteger<int16_t>();
+	}
+
+	CPARSER_CONSTEXPR int32_t readInt32() {
+		return readInteger<int32_t>();
+	}
+
+	CPARSER_CONSTEXPR uint8_t readUnsignedInt8() {
+		return readUnsignedInteger<uint8_t>();
+	}
+
+	CPARSER_CONSTEXPR uint16_t readUnsignedInt16() {
+		return readUnsignedInteger<uint16_t>();
+	}
+
+	CPARSER_CONSTEXPR uint32_t readUnsignedInt32() {
+		return readUnsignedInteger<uint32_t>();
+	}
+
+	// compare methods, same behaviour as CParser: only a matching string token
+	// moves the cursor past it, and a criterion compares true when it rejects
+	// the current item
+	CPARSER_CONSTEXPR bool compare(char token) {
+		return !isBufferOverflow() && m_buf[m_pos] == token;
+	}
+
+	CPARSER_CONSTEXPR bool compare(const char *token) {
+		size_t index = 0;
+		while (token[index] != '\0') {
+			if (m_pos + index >= m_len || m_buf[m_pos + index] != token[index]) {
+				return false;
+			}
+			index++;
+		}
+		m_pos += index;
+		return true;
+	}
+
+	CPARSER_CONSTEXPR bool compare(CParserCriterion criterion) {
+		return !isBufferOverflow() && !criterion(m_buf[m_pos]);
+	}
+
+	// The cursor moves past a matching token, a mismatch flags the view as in error
+	CPARSER_CONSTEXPR bool expect(char token) {
+		if (!compare(token)) {
+			return fail();
+		}
+		next();
+		return true;
+	}
+
+	CPARSER_CONSTEXPR bool expect(const char *token) {
+		return compare(token) || fail();
+	}
+
+	// skip methods, like CParser skip stops on the last item
+	CPARSER_CONSTEXPR void skip(size_t num_items) {
+		m_pos += num_items;
+		if (isBufferOverflow()) {
+			m_pos = m_len > 0 ? m_len - 1 : 0;
+		}
+	}
+
+	CPARSER_CONSTEXPR void skipWhile(char item) {
+		while (!isBufferOverflow() && m_buf[m_pos] == item) {
+			m_pos++;
+		}
+	}
+
+	CPARSER_CONSTEXPR void skipWhile(CParserCriterion comparision) {
+		while (!isBufferOverflow() && comparision(m_buf[m_pos])) {
+			m_pos++;
+		}
+	}
+
+	CPARSER_CONSTEXPR void skipUntil(char item) {
+		while (!isBufferOverflow() && m_buf[m_pos] != item) {
+			m_pos++;
+		}
+	}
+
+	CPARSER_CONSTEXPR void skipUntil(CParserCriterion comparision) {
+		while (!isBufferOverflow() && !comparision(m_buf[m_pos])) {
+			m_pos++;
+		}
+	}
+
+	// Jump methods
+	CPARSER_CONSTEXPR void jumpAfter(char item) {
+		jumpTo(item);
+		if (!isBufferOverflow()) {
+			m_pos++;
+		}
+	}
+
+	CPARSER_CONSTEXPR void jumpAfter(CParserCriterion comparision) {
+		jumpTo(comparision);
+		if (!isBufferOverflow()) {
+			m_pos++;
+		}
+	}
+
+	CPARSER_CONSTEXPR void jumpTo(char item) {
+		size_t index = m_pos;
+		while (index < m_len && m_buf[index] != item) {
+			index++;
+		}
+		if (index < m_len) {
+			m_pos = index;
+		}
+	}
+
+	CPARSER_CONSTEXPR void jumpTo(CParserCriterion comparision) {
+		size_t index = m_pos;
+		while (index < m_len && !comparision(m_buf[index])) {
+			index++;
+		}
+		if (index < m_len) {
+			m_pos = index;
+		}
+	}
+
+private:
+	const char *m_buf;
+	size_t m_pos;
+	size_t m_len;
+	bool m_error;
+
+	static constexpr size_t length(const char *str) {
+		return *str == '\0' ? 0 : 1 + length(str + 1);
+	}
+
+	CPARSER_CONSTEXPR void next() {
+		if (m_pos < m_len) {
+			m_pos++;
+		}
+	}
+
+	CPARSER_CONSTEXPR bool fail() {
+		m_error = true;
+		return false;
+	}
+
+	// Integer reads flag the view when no digit is found
+	template <class T_int> CPARSER_CONSTEXPR T_int readInteger() {
+		bool isNegative = compare('-');
+		if (isNegative) {
+			next();
+		}
+		if (isBufferOverflow() || !CParser::isDigit(m_buf[m_pos])) {
+			fail();
+			return 0;
+		}
+		T_int rst = 0;
+		while (!isBufferOverflow() && CParser::isDigit(m_buf[m_pos])) {
+			rst = (rst * 10) + (m_buf[m_pos] - '0');
+			m_pos++;
+		}
+		return isNegative ? -rst : rst;
+	}
+
+	template <class T_uint> CPARSER_CONSTEXPR T_uint readUnsignedInteger() {
+		if (isBufferOverflow() || !CParser::isDigit(m_buf[m_pos])) {
+			fail();
+			return 0;
+		}
+		T_uint rst = 0;
+		while (!isBufferOverflow() && CParser::isDigit(m_buf[m_pos])) {
+			rst = (rst * 10) + (m_buf[m_pos] - '0');
+			m_pos++;
+		}
+		return rst;
+	}
+};
+
+#endif
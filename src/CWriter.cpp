@@ -0,0 +1,664 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CWriter.cpp
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Writer counterpart of CParser: integer, float, hex and base64 formatting
+ *           into a caller buffer, no heap.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#include "CWriter.h"
+
+static const char digitPairs[] PROGMEM =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char hexDigits[] PROGMEM = "0123456789ABCDEF";
+
+static const char base64Digits[] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Unsigned big integer for the exact decimal conversion of floats: the largest
+// operand, a denormal scaled by 10^45, fits in 192 bits
+#define CWRITER_BIGNUM_WORDS 6
+
+class CWriterBignum {
+public:
+	CWriterBignum(uint32_t data) {
+		m_words[0] = data;
+		for (uint8_t index = 1; index < CWRITER_BIGNUM_WORDS; index++) {
+			m_words[index] = 0;
+		}
+	}
+
+	void shiftLeft(uint16_t bits) {
+		uint8_t words = bits / 32;
+		bits %= 32;
+		for (int8_t index = CWRITER_BIGNUM_WORDS - 1; index >= 0; index--) {
+			uint32_t word = index >= words ? m_words[index - words] << bits : 0;
+			if (bits != 0 && index > words) {
+				word |= m_words[index - words - 1] >> (32 - bits);
+			}
+			m_words[index] = word;
+		}
+	}
+
+	void multiply(uint32_t factor) {
+		uint64_t carry = 0;
+		for (uint8_t index = 0; index < CWRITER_BIGNUM_WORDS; index++) {
+			carry += (uint64_t)m_words[index] * factor;
+			m_words[index] = (uint32_t)carry;
+			carry >>= 32;
+		}
+	}
+
+	void multiplyPow10(uint16_t exponent) {
+		uint32_t factor = 1;
+		for (; exponent >= 9; exponent -= 9) {
+			multiply(1000000000UL);
+		}
+		while (exponent-- > 0) {
+			factor *= 10;
+		}
+		multiply(factor);
+	}
+
+	void add(const CWriterBignum &other) {
+		uint64_t carry = 0;
+		for (uint8_t index = 0; index < CWRITER_BIGNUM_WORDS; index++) {
+			carry += (uint64_t)m_words[index] + other.m_words[index];
+			m_words[index] = (uint32_t)carry;
+			carry >>= 32;
+		}
+	}
+
+	void subtract(const CWriterBignum &other) {
+		uint32_t borrow = 0;
+		for (uint8_t index = 0; index < CWRITER_BIGNUM_WORDS; index++) {
+			uint64_t difference = (uint64_t)m_words[index] - other.m_words[index] - borrow;
+			m_words[index] = (uint32_t)difference;
+			borrow = (uint32_t)(difference >> 63);
+		}
+	}
+
+	int8_t compare(const CWriterBignum &other) const {
+		for (int8_t index = CWRITER_BIGNUM_WORDS - 1; index >= 0; index--) {
+			if (m_words[index] != other.m_words[index]) {
+				return m_words[index] < other.m_words[index] ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	// Compares this + addend with other
+	int8_t compare(const CWriterBignum &addend, const CWriterBignum &other) const {
+		CWriterBignum sum = *this;
+		sum.add(addend);
+		return sum.compare(other);
+	}
+
+	// Quotient of a division known to be below 10, this keeps the remainder
+	uint8_t divide(const CWriterBignum &divisor) {
+		uint8_t quotient = 0;
+		while (compare(divisor) >= 0) {
+			subtract(divisor);
+			quotient++;
+		}
+		return quotient;
+	}
+
+private:
+	uint32_t m_words[CWRITER_BIGNUM_WORDS];
+};
+
+// Splits a finite float into mantissa * 2^exponent, returns true when the gap
+// to the next lower float is half the gap to the next higher one
+static bool decompose(float data, uint32_t &mantissa, int16_t &exponent) {
+	uint32_t bits;
+	memcpy(&bits, &data, sizeof(bits));
+
+	uint8_t biased = (bits >> 23) & 0xFF;
+	mantissa = bits & 0x7FFFFFUL;
+	if (biased == 0) {
+		exponent = -149;
+		return false;
+	}
+	mantissa |= 0x800000UL;
+	exponent = (int16_t)biased - 150;
+	return mantissa == 0x800000UL && biased > 1;
+}
+
+// Estimate of the decimal exponent from the binary one, log10(2) ~ 78913 / 2^18.
+// The callers correct it, so it only has to be close.
+static int16_t estimatePow10(uint32_t mantissa, int16_t exponent) {
+	int16_t log2 = exponent - 1;
+	while (mantissa != 0) {
+		mantissa >>= 1;
+		log2++;
+	}
+	int32_t scaled = (int32_t)log2 * 78913L;
+	return scaled >= 0 ? (int16_t)((scaled + 262143L) / 262144L) : (int16_t)-(-scaled / 262144L);
+}
+
+CWriter::CWriter() {
+	begin((byte *)nullptr, 0);
+}
+
+CWriter::CWriter(byte *buf, size_t len) {
+	begin(buf, len);
+}
+
+CWriter::CWriter(char *str, size_t size) {
+	begin(str, size);
+}
+
+CWriter::~CWriter() { }
+
+void CWriter::begin(byte *buf, size_t len) {
+	m_buf = buf;
+	m_len = len;
+	m_terminate = false;
+	m_separator = '\0';
+	reset();
+}
+
+// C string output: size includes the terminator, which follows every write
+void CWriter::begin(char *str, size_t size) {
+	begin((byte *)str, size > 0 ? size - 1 : 0);
+	m_terminate = size > 0;
+	reset();
+}
+
+void CWriter::reset() {
+	m_pos = 0;
+	m_pending = false;
+	m_overflow = false;
+	if (m_terminate) {
+		m_buf[m_pos] = '\0';
+	}
+}
+
+// Written between consecutive values; writeChar and writeByte (e.g. a line end)
+// start over, '\0' disables it
+void CWriter::setSeparator(char separator) {
+	m_separator = separator;
+}
+
+size_t CWriter::length() {
+	return m_pos;
+}
+
+size_t CWriter::available() {
+	return m_len - m_pos;
+}
+
+bool CWriter::isOverflow() {
+	return m_overflow;
+}
+
+// Write methods
+size_t CWriter::writeBool(bool data) {
+	return put(data ? "1" : "0", 1, true);
+}
+
+size_t CWriter::writeChar(char data) {
+	return put(&data, 1, false);
+}
+
+size_t CWriter::writeByte(byte data) {
+	return put((char *)&data, 1, false);
+}
+
+size_t CWriter::writeInt8(int8_t data) {
+	return writeInt32(data);
+}
+
+size_t CWriter::writeInt16(int16_t data) {
+	return writeInt32(data);
+}
+
+size_t CWriter::writeInt32(int32_t data) {
+	char text[11];
+	uint8_t count = formatUnsigned(data < 0 ? 0UL - (uint32_t)data : (uint32_t)data, text + sizeof(text));
+	if (data < 0) {
+		text[sizeof(text) - ++count] = '-';
+	}
+	return put(text + sizeof(text) - count, count, true);
+}
+
+size_t CWriter::writeUnsignedInt8(uint8_t data) {
+	return writeUnsignedInt32(data);
+}
+
+size_t CWriter::writeUnsignedInt16(uint16_t data) {
+	return writeUnsignedInt32(data);
+}
+
+size_t CWriter::writeUnsignedInt32(uint32_t data) {
+	char text[10];
+	uint8_t count = formatUnsigned(data, text + sizeof(text));
+	return put(text + sizeof(text) - count, count, true);
+}
+
+// Shortest digits that read back as the same float, plain notation for
+// 1e-5 <= |data| < 1e9 and exponent notation (1.5e-7) outside
+size_t CWriter::writeFloat(float data) {
+	if (data != data) {
+		return put("nan", 3, true);
+	}
+
+	char text[24];
+	size_t length = 0;
+	if (data < 0) {
+		text[length++] = '-';
+		data = -data;
+	}
+	if (data > 3.40282347e+38f) {
+		memcpy(text + length, "inf", 3);
+		return put(text, length + 3, true);
+	}
+	if (data == 0) {
+		return put("0", 1, true);
+	}
+
+	char digits[12];
+	int16_t point;
+	uint8_t count = shortestDigits(data, digits, point);
+
+	if (point > -5 && point <= 9) {
+		if (point <= 0) {
+			text[length++] = '0';
+			text[length++] = '.';
+			for (int16_t index = point; index < 0; index++) {
+				text[length++] = '0';
+			}
+		}
+		for (int16_t index = 0; index < count || index < point; index++) {
+			if (index == point && point > 0) {
+				text[length++] = '.';
+			}
+			text[length++] = index < count ? digits[index] : '0';
+		}
+	} else {
+		text[length++] = digits[0];
+		if (count > 1) {
+			text[length++] = '.';
+			memcpy(text + length, digits + 1, count - 1);
+			length += count - 1;
+		}
+		text[length++] = 'e';
+		if (point <= 0) {
+			text[length++] = '-';
+		}
+		char exponent[3];
+		uint8_t size = formatUnsigned(point > 0 ? point - 1 : 1 - point, exponent + sizeof(exponent));
+		memcpy(text + length, exponent + sizeof(exponent) - size, size);
+		length += size;
+	}
+	return put(text, length, true);
+}
+
+// Fixed number of decimals, rounded half to even on the exact value. More
+// than CWRITER_MAX_DECIMALS decimals do not fit the buffers and overflow.
+size_t CWriter::writeFloat(float data, uint8_t decimals) {
+	if (decimals > CWRITER_MAX_DECIMALS) {
+		m_overflow = true;
+		return 0;
+	}
+	if (data != data) {
+		return put("nan", 3, true);
+	}
+
+	char text[CWRITER_MAX_DECIMALS + 47];
+	size_t length = 0;
+	bool isNegative = data < 0;
+	if (isNegative) {
+		data = -data;
+	}
+	if (data > 3.40282347e+38f) {
+		return put(isNegative ? "-inf" : "inf", isNegative ? 4 : 3, true);
+	}
+
+	char digits[CWRITER_MAX_DECIMALS + 43];
+	int16_t point;
+	uint8_t count = fixedDigits(data, decimals, digits, point);
+
+	if (isNegative && count > 0) {
+		text[length++] = '-';
+	}
+	if (point <= 0) {
+		text[length++] = '0';
+	}
+	for (int16_t index = 0; index < point; index++) {
+		text[length++] = index < count ? digits[index] : '0';
+	}
+	if (decimals > 0) {
+		text[length++] = '.';
+		for (int16_t index = point; index < point + decimals; index++) {
+			text[length++] = index >= 0 && index < count ? digits[index] : '0';
+		}
+	}
+	return put(text, length, true);
+}
+
+// Fixed point counterpart of readDecimal: data / 10^scale with scale decimals,
+// formatted in place since any scale is exact with enough leading zeros
+size_t CWriter::writeDecimal(int32_t data, uint8_t scale) {
+	char digits[10];
+	uint8_t count = formatUnsigned(data < 0 ? 0UL - (uint32_t)data : (uint32_t)data, digits + sizeof(digits));
+	const char *first = digits + sizeof(digits) - count;
+	int16_t integer = (int16_t)count - scale;
+
+	size_t length = (data < 0 ? 1 : 0) + (integer > 0 ? integer : 1) + (scale > 0 ? scale + 1 : 0);
+	size_t start = m_pos;
+	byte *text = reserve(length, true);
+	if (text == nullptr) {
+		return 0;
+	}
+
+	if (data < 0) {
+		*text++ = '-';
+	}
+	if (integer <= 0) {
+		*text++ = '0';
+	} else {
+		memcpy(text, first, integer);
+		text += integer;
+	}
+	if (scale > 0) {
+		*text++ = '.';
+		for (int16_t index = integer; index < integer + scale; index++) {
+			*text++ = index >= 0 ? first[index] : '0';
+		}
+	}
+	return m_pos - start;
+}
+
+size_t CWriter::writeCharArray(const char *data) {
+	return put(data, strlen(data), true);
+}
+
+size_t CWriter::writeCharArray(const char *data, size_t length) {
+	return put(data, length, true);
+}
+
+size_t CWriter::writeString(const String &data) {
+	return put(data.c_str(), data.length(), true);
+}
+
+// Encoding methods
+size_t CWriter::writeHex(uint32_t data, uint8_t digits) {
+	char text[8];
+	uint8_t count = 0;
+	do {
+		text[sizeof(text) - ++count] = pgm_read_byte(&hexDigits[data & 0x0F]);
+		data >>= 4;
+	} while ((data != 0 || count < digits) && count < sizeof(text));
+	return put(text + sizeof(text) - count, count, true);
+}
+
+size_t CWriter::writeHex(const byte *data, size_t length) {
+	size_t start = m_pos;
+	byte *text = reserve(length <= m_len / 2 ? length * 2 : m_len + 1, true);
+	if (text == nullptr) {
+		return 0;
+	}
+	for (size_t index = 0; index < length; index++) {
+		*text++ = pgm_read_byte(&hexDigits[data[index] >> 4]);
+		*text++ = pgm_read_byte(&hexDigits[data[index] & 0x0F]);
+	}
+	return m_pos - start;
+}
+
+// Standard alphabet with padding
+size_t CWriter::writeBase64(const byte *data, size_t length) {
+	size_t start = m_pos;
+	size_t groups = length / 3 + (length % 3 != 0 ? 1 : 0);
+	byte *text = reserve(groups <= m_len / 4 ? groups * 4 : m_len + 1, true);
+	if (text == nullptr) {
+		return 0;
+	}
+	for (size_t index = 0; index < length; index += 3) {
+		size_t left = length - index;
+		uint32_t group = (uint32_t)data[index] << 16;
+		if (left > 1) {
+			group |= (uint32_t)data[index + 1] << 8;
+		}
+		if (left > 2) {
+			group |= data[index + 2];
+		}
+		*text++ = pgm_read_byte(&base64Digits[(group >> 18) & 0x3F]);
+		*text++ = pgm_read_byte(&base64Digits[(group >> 12) & 0x3F]);
+		*text++ = left > 1 ? pgm_read_byte(&base64Digits[(group >> 6) & 0x3F]) : '=';
+		*text++ = left > 2 ? pgm_read_byte(&base64Digits[group & 0x3F]) : '=';
+	}
+	return m_pos - start;
+}
+
+// Private methods
+byte *CWriter::reserve(size_t length, bool field) {
+	size_t separator = (field && m_pending && m_separator != '\0') ? 1 : 0;
+	if (m_overflow || length > m_len - m_pos || separator > m_len - m_pos - length) {
+		m_overflow = true;
+		return nullptr;
+	}
+
+	if (separator > 0) {
+		m_buf[m_pos++] = m_separator;
+	}
+	byte *data = m_buf + m_pos;
+	m_pos += length;
+	if (m_terminate) {
+		m_buf[m_pos] = '\0';
+	}
+	m_pending = field;
+	return data;
+}
+
+size_t CWriter::put(const char *data, size_t length, bool field) {
+	size_t start = m_pos;
+	byte *text = reserve(length, field);
+	if (text == nullptr) {
+		return 0;
+	}
+	memcpy(text, data, length);
+	return m_pos - start;
+}
+
+// Writes the decimal digits of data backwards from end, two per division
+uint8_t CWriter::formatUnsigned(uint32_t data, char *end) {
+	char *cursor = end;
+	while (data >= 100) {
+		uint8_t pair = (data % 100) * 2;
+		data /= 100;
+		*--cursor = pgm_read_byte(&digitPairs[pair + 1]);
+		*--cursor = pgm_read_byte(&digitPairs[pair]);
+	}
+	if (data >= 10) {
+		*--cursor = pgm_read_byte(&digitPairs[data * 2 + 1]);
+		*--cursor = pgm_read_byte(&digitPairs[data * 2]);
+	} else {
+		*--cursor = '0' + data;
+	}
+	return end - cursor;
+}
+
+// Free-format conversion (Steele & White, Burger & Dybvig) of a positive finite
+// float: the fewest digits d1 d2 ... such that 0.d1d2... * 10^point lies strictly
+// inside the rounding interval of data (inclusive when the mantissa is even).
+uint8_t CWriter::shortestDigits(float data, char *digits, int16_t &point) {
+	uint32_t mantissa;
+	int16_t exponent;
+	bool isUnequal = decompose(data, mantissa, exponent);
+	bool isEven = (mantissa & 1) == 0;
+
+	// data = r / s, the interval is (data - low / s, data + high / s)
+	CWriterBignum r(mantissa);
+	CWriterBignum s(1);
+	CWriterBignum high(1);
+	CWriterBignum low(1);
+	if (exponent >= 0) {
+		r.shiftLeft(exponent + (isUnequal ? 2 : 1));
+		s.shiftLeft(isUnequal ? 2 : 1);
+		high.shiftLeft(exponent + (isUnequal ? 1 : 0));
+		low.shiftLeft(exponent);
+	} else {
+		r.shiftLeft(isUnequal ? 2 : 1);
+		s.shiftLeft(-exponent + (isUnequal ? 2 : 1));
+		high.shiftLeft(isUnequal ? 1 : 0);
+	}
+
+	int16_t k = estimatePow10(mantissa, exponent);
+	if (k >= 0) {
+		s.multiplyPow10(k);
+	} else {
+		r.multiplyPow10(-k);
+		high.multiplyPow10(-k);
+		low.multiplyPow10(-k);
+	}
+
+	// smallest k with data + high below 10^k
+	while (isEven ? r.compare(high, s) >= 0 : r.compare(high, s) > 0) {
+		s.multiply(10);
+		k++;
+	}
+	while (true) {
+		CWriterBignum upper = r;
+		upper.add(high);
+		upper.multiply(10);
+		if (isEven ? upper.compare(s) >= 0 : upper.compare(s) > 0) {
+			break;
+		}
+		r.multiply(10);
+		high.multiply(10);
+		low.multiply(10);
+		k--;
+	}
+
+	uint8_t count = 0;
+	while (true) {
+		r.multiply(10);
+		high.multiply(10);
+		low.multiply(10);
+		uint8_t digit = r.divide(s);
+		bool isLowEnough = isEven ? r.compare(low) <= 0 : r.compare(low) < 0;
+		bool isHighEnough = isEven ? r.compare(high, s) >= 0 : r.compare(high, s) > 0;
+
+		if (!isLowEnough && !isHighEnough) {
+			digits[count++] = '0' + digit;
+			continue;
+		}
+		if (isLowEnough && isHighEnough) {
+			CWriterBignum twice = r;
+			twice.shiftLeft(1);
+			if (twice.compare(s) >= 0) {
+				digit++;
+			}
+		} else if (isHighEnough) {
+			digit++;
+		}
+		digits[count++] = '0' + digit;
+		break;
+	}
+
+	point = k;
+	return count;
+}
+
+// Exact digits of a positive finite float down to 10^-decimals, rounded half to
+// even: 0.d1d2... * 10^point, no digits when it rounds to zero
+uint8_t CWriter::fixedDigits(float data, uint8_t decimals, char *digits, int16_t &point) {
+	uint32_t mantissa;
+	int16_t exponent;
+	decompose(data, mantissa, exponent);
+
+	point = 0;
+	if (mantissa == 0) {
+		return 0;
+	}
+
+	CWriterBignum r(mantissa);
+	CWriterBignum s(1);
+	if (exponent >= 0) {
+		r.shiftLeft(exponent);
+	} else {
+		s.shiftLeft(-exponent);
+	}
+
+	int16_t k = estimatePow10(mantissa, exponent);
+	if (k >= 0) {
+		s.multiplyPow10(k);
+	} else {
+		r.multiplyPow10(-k);
+	}
+
+	// 0.1 <= r / s < 1
+	while (r.compare(s) >= 0) {
+		s.multiply(10);
+		k++;
+	}
+	while (true) {
+		CWriterBignum upper = r;
+		upper.multiply(10);
+		if (upper.compare(s) >= 0) {
+			break;
+		}
+		r.multiply(10);
+		k--;
+	}
+
+	point = k;
+	if (k + decimals < 0) {
+		return 0;
+	}
+
+	uint8_t count = 0;
+	while (count < k + decimals) {
+		r.multiply(10);
+		digits[count++] = '0' + r.divide(s);
+	}
+
+	r.shiftLeft(1);
+	int8_t half = r.compare(s);
+	if (half > 0 || (half == 0 && count > 0 && (digits[count - 1] & 1) != 0)) {
+		uint8_t index = count;
+		while (index > 0 && digits[index - 1] == '9') {
+			digits[--index] = '0';
+		}
+		if (index > 0) {
+			digits[index - 1]++;
+		} else {
+			memmove(digits + 1, digits, count++);
+			digits[0] = '1';
+			point++;
+		}
+	}
+	return count;
+}
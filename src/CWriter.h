@@ -0,0 +1,101 @@
+/************************************************************************************
+ * 
+ * Name    : CParser
+ * File    : CWriter.h
+ * Author  : Mark Reds <marco@markreds.it>
+ * Date    : October 19, 2026
+ * Version : 1.0.0
+ * Notes   : Writer counterpart of CParser: integer, float, hex and base64 formatting
+ *           into a caller buffer, no heap.
+ * 
+ * Copyright (C) 2020 Marco Rossi (aka Mark Reds).  All right reserved.
+ * 
+ * This file is part of CParser.
+ * 
+ * CParser is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * CParser is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with CParser. If not, see <http://www.gnu.org/licenses/>.
+ * 
+ ************************************************************************************/
+
+#ifndef _CWriter_h_
+#define _CWriter_h_
+
+#include "CParser.h"
+
+// Upper bound of the decimals of writeFloat, at most 149 (a float has no
+// nonzero digit past 10^-149); the digit buffers on the stack grow with it
+#ifndef CWRITER_MAX_DECIMALS
+#define CWRITER_MAX_DECIMALS 9
+#endif
+
+// Every write is all or nothing: a value that does not fit is not written and
+// sets the overflow flag, which blocks further writes until begin() or reset()
+// so that a frame never misses a field in the middle. Write methods return the
+// number of bytes written, separator included.
+class CWriter {
+public:
+	CWriter();
+	CWriter(byte *buf, size_t len);
+	CWriter(char *str, size_t size);
+	virtual ~CWriter();
+
+	void begin(byte *buf, size_t len);
+	void begin(char *str, size_t size);
+	void reset();
+	void setSeparator(char separator);
+
+	size_t length();
+	size_t available();
+	bool isOverflow();
+
+	// Write methods
+	size_t writeBool(bool data);
+	size_t writeChar(char data);
+	size_t writeByte(byte data);
+	size_t writeInt8(int8_t data);
+	size_t writeInt16(int16_t data);
+	size_t writeInt32(int32_t data);
+	size_t writeUnsignedInt8(uint8_t data);
+	size_t writeUnsignedInt16(uint16_t data);
+	size_t writeUnsignedInt32(uint32_t data);
+
+	size_t writeFloat(float data);
+	size_t writeFloat(float data, uint8_t decimals);
+	size_t writeDecimal(int32_t data, uint8_t scale);
+
+	size_t writeCharArray(const char *data);
+	size_t writeCharArray(const char *data, size_t length);
+	size_t writeString(const String &data);
+
+	// Encoding methods
+	size_t writeHex(uint32_t data, uint8_t digits = 0);
+	size_t writeHex(const byte *data, size_t length);
+	size_t writeBase64(const byte *data, size_t length);
+
+private:
+	byte *m_buf;
+	size_t m_pos;
+	size_t m_len;
+	char m_separator;
+	bool m_pending;
+	bool m_terminate;
+	bool m_overflow;
+
+	byte *reserve(size_t length, bool field);
+	size_t put(const char *data, size_t length, bool field);
+	static uint8_t formatUnsigned(uint32_t data, char *end);
+	static uint8_t shortestDigits(float data, char *digits, int16_t &point);
+	static uint8_t fixedDigits(float data, uint8_t decimals, char *digits, int16_t &point);
+};
+
+#endif